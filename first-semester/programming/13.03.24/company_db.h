@@ -0,0 +1,636 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <set>
+#include <string>
+#include <vector>
+#include "company_store.h"
+#include "company_io.h"
+
+// Company registry kept in one file: a header page, the codes,
+// paid_taxes_amounts and name_offsets columns with room for capacity
+// records, the names arena and a write-ahead log. Every region starts on a
+// page of the size in the header, the page size of the system which created
+// the file, it is opened where pages divide it. Opening the file maps it and
+// points columns of a CompanyStore into the mapping, so startup does not
+// depend on amount of records and queries read the columns straight from the
+// file. Sum of paid taxes amounts is kept in the header, lookups by code and
+// the lowest and highest amounts scan the mapped columns while the code index
+// and tax order of the store are built in another thread, the first change or
+// query which needs them waits for it.
+//
+// The columns are mapped privately, changes stay in memory until a
+// checkpoint, only the log is mapped shared. Every change is appended to the
+// log as after-images of the changed bytes followed by a commit record,
+// company_db_commit makes logged changes durable with one msync and runs
+// every COMPANY_DB_COMMIT_RECORDS changes. A checkpoint writes changed pages
+// to the file and starts a new log generation, it runs when the log is
+// COMPANY_DB_CHECKPOINT_PERCENT full and on close. Opening after a crash
+// replays the changes of the current generation which reached their commit
+// record, a record with wrong checksum ends the log and records of a change
+// cut off by it are dropped.
+//
+// A change which does not fit the columns or the names arena writes the
+// records to a new file with twice the room for them and renames it over the
+// database. The same copy with the same room is made instead of a checkpoint
+// when names of updated and removed records are more than half of the names
+// arena, the copy has names of the records only. A crash leaves the old file
+// or the new one, both are whole.
+
+#define COMPANY_DB_COMMIT_RECORDS 256
+#define COMPANY_DB_CHECKPOINT_PERCENT 75
+#define COMPANY_DB_MIN_CAPACITY 64
+
+// names_garbage is the bytes of names of no record, it is logged with the
+// lengths and taxes_sum before it.
+struct CompanyDatabaseHeader {
+	char magic[8];
+	long page_size;
+	long capacity;
+	long names_capacity;
+	long wal_capacity;
+	long length;
+	long names_length;
+	long long taxes_sum;
+	long names_garbage;
+	long checkpoint_sequence;
+	long codes_offset;
+	long paid_taxes_amounts_offset;
+	long name_offsets_offset;
+	long names_offset;
+	long wal_offset;
+	long file_size;
+};
+
+// Followed by size bytes to be copied to offset of the file, padded to 8. A
+// commit record ends a change, it has offset COMPANY_DB_COMMIT_OFFSET and no
+// bytes.
+#define COMPANY_DB_COMMIT_OFFSET -1
+
+struct CompanyWalRecord {
+	long sequence;
+	long offset;
+	long size;
+	uint64_t checksum;
+};
+
+struct CompanyDatabase {
+	char * path;
+	int fd;
+	long page_size;
+	char * data;
+	long data_size;
+	char * wal;
+	long wal_capacity;
+	long wal_length;
+	long wal_synced;
+	long pending;
+	CompanyDatabaseHeader * header;
+	std::set<long> * dirty_pages;
+	CompanyStore * store;
+};
+
+inline long company_db_align(long size, long alignment){
+	return (size + alignment - 1) / alignment * alignment;
+};
+
+// Page size of the system, regions of a new file are aligned to it.
+inline long company_db_system_page_size(){
+	static const long page_size = sysconf(_SC_PAGESIZE);
+
+	return page_size;
+};
+
+inline uint64_t company_db_checksum(const CompanyWalRecord * record, const char * bytes){
+	uint64_t hash = 14695981039346656037ULL;
+	const char * fields = (const char *) record;
+
+	for(long i = 0; i < (long) offsetof(CompanyWalRecord, checksum); i++)
+		hash = (hash ^ (unsigned char) fields[i]) * 1099511628211ULL;
+	for(long i = 0; i < record->size; i++)
+		hash = (hash ^ (unsigned char) bytes[i]) * 1099511628211ULL;
+
+	return hash;
+};
+
+inline long company_db_wal_record_size(long size){
+	return sizeof(CompanyWalRecord) + company_db_align(size, 8);
+};
+
+// Appends after-image of size bytes at address in the mapping to the log.
+// Callers make sure there is room with company_db_reserve_wal.
+inline void company_db_log(CompanyDatabase * db, const void * address, long size){
+	CompanyWalRecord * record = (CompanyWalRecord *) (db->wal + db->wal_length);
+	long offset = (const char *) address - db->data;
+
+	if(size == 0)
+		return;
+
+	record->sequence = db->header->checkpoint_sequence;
+	record->offset = offset;
+	record->size = size;
+	memcpy(record + 1, address, size);
+	record->checksum = company_db_checksum(record, (const char *) (record + 1));
+	db->wal_length += company_db_wal_record_size(size);
+
+	for(long page = offset / db->page_size; page <= (offset + size - 1) / db->page_size; page++)
+		db->dirty_pages->insert(page);
+};
+
+// Ends the change logged since the previous commit record, replay applies
+// its records only when this one is in the log.
+inline void company_db_log_commit(CompanyDatabase * db){
+	CompanyWalRecord * record = (CompanyWalRecord *) (db->wal + db->wal_length);
+
+	record->sequence = db->header->checkpoint_sequence;
+	record->offset = COMPANY_DB_COMMIT_OFFSET;
+	record->size = 0;
+	record->checksum = company_db_checksum(record, NULL);
+	db->wal_length += company_db_wal_record_size(0);
+};
+
+inline void company_db_log_record(CompanyDatabase * db, long index){
+	CompanyStore * store = db->store;
+
+	company_db_log(db, &store->codes[index], sizeof(int));
+	company_db_log(db, &store->paid_taxes_amounts[index], sizeof(int));
+	company_db_log(db, &store->name_offsets[index], sizeof(long));
+};
+
+// Logs names added after names_length and the new lengths, taxes sum and
+// names garbage of the header, callers count the garbage in the header.
+inline void company_db_log_lengths(CompanyDatabase * db, long names_length){
+	CompanyStore * store = db->store;
+
+	company_db_log(db, store->names + names_length, store->names_length - names_length);
+	db->header->length = store->length;
+	db->header->names_length = store->names_length;
+	db->header->taxes_sum = store->taxes_sum;
+	company_db_log(db, &db->header->length, 4 * sizeof(long));
+};
+
+// Makes everything logged so far durable.
+inline bool company_db_commit(CompanyDatabase * db){
+	long start = db->wal_synced / db->page_size * db->page_size;
+
+	db->pending = 0;
+	if(db->wal_length == db->wal_synced)
+		return true;
+	if(msync(db->wal + start, db->wal_length - start, MS_SYNC) != 0)
+		return false;
+	db->wal_synced = db->wal_length;
+
+	return true;
+};
+
+// Writes the header page as it is in the mapping.
+inline bool company_db_write_header(CompanyDatabase * db){
+	return pwrite(db->fd, db->data, db->page_size, 0) == db->page_size && fdatasync(db->fd) == 0;
+};
+
+// Writes changed pages to the file, then the header with the next log
+// generation, which drops all records of the log. A crash before the header
+// is written replays the same after-images again.
+inline bool company_db_checkpoint(CompanyDatabase * db){
+	auto it = db->dirty_pages->begin();
+
+	if(!company_db_commit(db))
+		return false;
+
+	while(it != db->dirty_pages->end()){
+		long first = *it, last = *it;
+
+		while(++it != db->dirty_pages->end() && *it == last + 1)
+			last++;
+		long size = (last - first + 1) * db->page_size;
+		if(pwrite(db->fd, db->data + first * db->page_size, size, first * db->page_size) != size)
+			return false;
+	}
+	if(fdatasync(db->fd) != 0)
+		return false;
+
+	db->header->checkpoint_sequence++;
+	if(!company_db_write_header(db))
+		return false;
+
+	db->dirty_pages->clear();
+	db->wal_length = 0;
+	db->wal_synced = 0;
+
+	return true;
+};
+
+// Makes room for size bytes of records, false when a change of this size can
+// not fit the log at all.
+inline bool company_db_reserve_wal(CompanyDatabase * db, long size){
+	if(db->wal_length + size <= db->header->wal_capacity)
+		return true;
+
+	return size <= db->header->wal_capacity && company_db_checkpoint(db);
+};
+
+// Log size of a change of one record with a new name of name_length bytes.
+inline long company_db_change_size(long name_length){
+	return 3 * company_db_wal_record_size(sizeof(long)) + company_db_wal_record_size(name_length + 1) +
+		company_db_wal_record_size(4 * sizeof(long)) + company_db_wal_record_size(0);
+};
+
+inline bool company_db_is_commit_record(const CompanyWalRecord * record){
+	return record->offset == COMPANY_DB_COMMIT_OFFSET && record->size == 0;
+};
+
+// Finds the end of the last commit record of the valid records, then applies
+// the records before it. When the log held records, the replayed changes are
+// checkpointed, so records left after them, of a cut off change or written
+// out of order before the crash, can not be taken for a part of the log later.
+inline bool company_db_replay(CompanyDatabase * db){
+	long position = 0, committed = 0;
+
+	while(position + (long) sizeof(CompanyWalRecord) <= db->header->wal_capacity){
+		CompanyWalRecord * record = (CompanyWalRecord *) (db->wal + position);
+
+		if(record->sequence != db->header->checkpoint_sequence ||
+			!(company_db_is_commit_record(record) || (record->size > 0 &&
+			record->size <= db->header->wal_capacity - position - (long) sizeof(CompanyWalRecord) &&
+			record->offset >= 0 && record->offset <= db->data_size - record->size)) ||
+			record->checksum != company_db_checksum(record, (const char *) (record + 1)))
+			break;
+
+		position += company_db_wal_record_size(record->size);
+		if(company_db_is_commit_record(record))
+			committed = position;
+	}
+
+	for(long i = 0; i < committed; ){
+		CompanyWalRecord * record = (CompanyWalRecord *) (db->wal + i);
+
+		if(!company_db_is_commit_record(record)){
+			memcpy(db->data + record->offset, record + 1, record->size);
+			for(long page = record->offset / db->page_size; page <= (record->offset + record->size - 1) / db->page_size; page++)
+				db->dirty_pages->insert(page);
+		}
+		i += company_db_wal_record_size(record->size);
+	}
+	db->wal_length = committed;
+	db->wal_synced = committed;
+
+	return db->header->length >= 0 && db->header->length <= db->header->capacity &&
+		db->header->names_length >= 0 && db->header->names_length <= db->header->names_capacity &&
+		db->header->names_garbage >= 0 && db->header->names_garbage <= db->header->names_length &&
+		(position == 0 || company_db_checkpoint(db));
+};
+
+// Fills the header of an empty database with pages of page_size bytes.
+inline void company_db_layout(CompanyDatabaseHeader * header, long page_size, long capacity, long names_capacity, long wal_capacity){
+	memcpy(header->magic, "COMPANY3", 8);
+	header->page_size = page_size;
+	header->capacity = capacity;
+	header->names_capacity = names_capacity;
+	header->wal_capacity = company_db_align(wal_capacity, page_size);
+	header->length = 0;
+	header->names_length = 0;
+	header->taxes_sum = 0;
+	header->names_garbage = 0;
+	header->checkpoint_sequence = 1;
+	header->codes_offset = page_size;
+	header->paid_taxes_amounts_offset = header->codes_offset + company_db_align(capacity * sizeof(int), page_size);
+	header->name_offsets_offset = header->paid_taxes_amounts_offset + company_db_align(capacity * sizeof(int), page_size);
+	header->names_offset = header->name_offsets_offset + company_db_align(capacity * sizeof(long), page_size);
+	header->wal_offset = header->names_offset + company_db_align(names_capacity, page_size);
+	header->file_size = header->wal_offset + header->wal_capacity;
+};
+
+inline bool company_db_create(int fd, long capacity, long names_capacity, long wal_capacity){
+	CompanyDatabaseHeader header = {};
+
+	if(capacity < 0 || names_capacity < 0 || wal_capacity <= 0)
+		return false;
+	company_db_layout(&header, company_db_system_page_size(), capacity, names_capacity, wal_capacity);
+
+	// file is sparse, regions take disk space when they are written, the
+	// rest of the header page is zeros
+	return ftruncate(fd, header.file_size) == 0 &&
+		pwrite(fd, &header, sizeof(header), 0) == sizeof(header) && fdatasync(fd) == 0;
+};
+
+// Points columns of the store into the mapping.
+inline void company_db_point_store(CompanyDatabase * db){
+	CompanyStore * store = db->store;
+
+	store->codes = (int *) (db->data + db->header->codes_offset);
+	store->paid_taxes_amounts = (int *) (db->data + db->header->paid_taxes_amounts_offset);
+	store->name_offsets = (long *) (db->data + db->header->name_offsets_offset);
+	store->names = db->data + db->header->names_offset;
+	store->length = db->header->length;
+	store->capacity = db->header->capacity;
+	store->names_length = db->header->names_length;
+	store->names_capacity = db->header->names_capacity;
+};
+
+// Makes a rename in the directory of path durable.
+inline bool company_db_sync_directory(const char * path){
+	std::string directory(path);
+	size_t slash = directory.rfind('/');
+	int fd;
+	bool is_synced;
+
+	directory = slash == std::string::npos ? "." : directory.substr(0, std::max(slash, (size_t) 1));
+	fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	is_synced = fd >= 0 && fsync(fd) == 0;
+	if(fd >= 0)
+		close(fd);
+
+	return is_synced;
+};
+
+// Checkpoints, then writes the records to path.new with room for capacity
+// records and names_capacity bytes of names, the names of the records one
+// after another, maps it and renames it over the database. The database is
+// not changed when anything before the rename fails.
+inline bool company_db_rewrite(CompanyDatabase * db, long capacity, long names_capacity){
+	CompanyStore * store = db->store;
+	std::string new_path = std::string(db->path) + ".new";
+	CompanyDatabaseHeader header = {};
+	std::vector<long> name_offsets(store->length);
+	std::vector<char> names;
+	char * data = (char *) MAP_FAILED, * wal = (char *) MAP_FAILED;
+	long column_size = store->length * sizeof(int), offsets_size = store->length * sizeof(long);
+	bool is_written;
+	int fd;
+
+	// the index builder reads the columns which are unmapped below
+	company_store_ensure_indexes(store);
+	if(!company_db_checkpoint(db))
+		return false;
+
+	for(long i = 0; i < store->length; i++){
+		const char * name = company_store_name(store, i);
+
+		name_offsets[i] = names.size();
+		names.insert(names.end(), name, name + strlen(name) + 1);
+	}
+	if(store->length > capacity || (long) names.size() > names_capacity)
+		return false;
+
+	company_db_layout(&header, db->page_size, capacity, names_capacity, db->header->wal_capacity);
+	header.length = store->length;
+	header.names_length = names.size();
+	header.taxes_sum = store->taxes_sum;
+
+	fd = open(new_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+	is_written = ftruncate(fd, header.file_size) == 0 &&
+		pwrite(fd, store->codes, column_size, header.codes_offset) == column_size &&
+		pwrite(fd, store->paid_taxes_amounts, column_size, header.paid_taxes_amounts_offset) == column_size &&
+		pwrite(fd, name_offsets.data(), offsets_size, header.name_offsets_offset) == offsets_size &&
+		pwrite(fd, names.data(), names.size(), header.names_offset) == (long) names.size() &&
+		pwrite(fd, &header, sizeof(header), 0) == sizeof(header) && fdatasync(fd) == 0;
+	if(is_written){
+		data = (char *) mmap(NULL, header.wal_offset, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		wal = (char *) mmap(NULL, header.wal_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, header.wal_offset);
+	}
+	if(data == MAP_FAILED || wal == MAP_FAILED || rename(new_path.c_str(), db->path) != 0){
+		if(data != MAP_FAILED)
+			munmap(data, header.wal_offset);
+		if(wal != MAP_FAILED)
+			munmap(wal, header.wal_capacity);
+		close(fd);
+		unlink(new_path.c_str());
+		return false;
+	}
+
+	munmap(db->data, db->data_size);
+	munmap(db->wal, db->wal_capacity);
+	close(db->fd);
+	db->fd = fd;
+	db->data = data;
+	db->data_size = header.wal_offset;
+	db->wal = wal;
+	db->wal_capacity = header.wal_capacity;
+	db->header = (CompanyDatabaseHeader *) data;
+	company_db_point_store(db);
+
+	// changes logged to the new file are lost when the rename is
+	return company_db_sync_directory(db->path);
+};
+
+// Checkpoints, or makes a compacted copy of the database when names of no
+// record are more than half of the names arena and at least a page.
+inline bool company_db_checkpoint_compacting(CompanyDatabase * db){
+	if(2 * db->header->names_garbage > db->header->names_length && db->header->names_garbage >= db->page_size)
+		return company_db_rewrite(db, db->header->capacity, db->header->names_capacity);
+
+	return company_db_checkpoint(db);
+};
+
+// Makes room for record_amount more records and names_length more bytes of
+// names. When they do not fit, the database is copied with the capacity
+// which ran out doubled until they fit, names with half of the arena free
+// after the names of no record are dropped.
+inline bool company_db_make_room(CompanyDatabase * db, long record_amount, long names_length){
+	CompanyStore * store = db->store;
+	long capacity = store->capacity, names_capacity = store->names_capacity;
+	long live_names_length = store->names_length - db->header->names_garbage;
+
+	if(store->length + record_amount <= capacity && store->names_length + names_length <= names_capacity)
+		return true;
+
+	if(store->length + record_amount > capacity)
+		for(capacity = std::max(capacity, (long) COMPANY_DB_MIN_CAPACITY); store->length + record_amount > capacity; capacity *= 2);
+	if(store->names_length + names_length > names_capacity)
+		for(names_capacity = std::max(names_capacity, db->page_size); 2 * (live_names_length + names_length) > names_capacity; names_capacity *= 2);
+
+	return company_db_rewrite(db, capacity, names_capacity);
+};
+
+// Ends the logged change, commits or checkpoints when it is time to.
+inline void company_db_finish_change(CompanyDatabase * db){
+	company_db_log_commit(db);
+	if(++db->pending >= COMPANY_DB_COMMIT_RECORDS)
+		company_db_commit(db);
+	if(db->wal_length * 100 >= db->header->wal_capacity * COMPANY_DB_CHECKPOINT_PERCENT)
+		company_db_checkpoint_compacting(db);
+};
+
+inline void close_company_database(CompanyDatabase * db, bool is_checkpointed);
+
+// Opens database at path, creates it with room for capacity records,
+// names_capacity bytes of names and wal_capacity bytes of log when the file
+// does not exist, records and names of an existing file get more room when
+// they need it, its log keeps its size. Returns NULL when the file can not be
+// created, mapped or is not a company database. A copy left by a crash
+// during company_db_rewrite is removed.
+inline CompanyDatabase * open_company_database(const char * path, long capacity, long names_capacity, long wal_capacity){
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+	struct stat file_stat;
+	CompanyDatabaseHeader header;
+	CompanyDatabase * db;
+
+	if(fd < 0)
+		return NULL;
+	if(fstat(fd, &file_stat) != 0 || (file_stat.st_size == 0 && !company_db_create(fd, capacity, names_capacity, wal_capacity)) ||
+		pread(fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, "COMPANY3", 8) != 0 ||
+		header.page_size <= 0 || header.page_size % company_db_system_page_size() != 0 ||
+		fstat(fd, &file_stat) != 0 || header.file_size != file_stat.st_size){
+		close(fd);
+		return NULL;
+	}
+	unlink((std::string(path) + ".new").c_str());
+
+	db = (CompanyDatabase *) malloc(sizeof(CompanyDatabase));
+	db->path = strdup(path);
+	db->fd = fd;
+	db->page_size = header.page_size;
+	db->data_size = header.wal_offset;
+	db->data = (char *) mmap(NULL, db->data_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	db->wal_capacity = header.wal_capacity;
+	db->wal = (char *) mmap(NULL, header.wal_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, header.wal_offset);
+	db->header = (CompanyDatabaseHeader *) db->data;
+	db->pending = 0;
+	db->dirty_pages = new std::set<long>();
+	db->store = NULL;
+	if(db->data == MAP_FAILED || db->wal == MAP_FAILED || !company_db_replay(db)){
+		close_company_database(db, false);
+		return NULL;
+	}
+
+	db->store = get_company_store();
+	company_db_point_store(db);
+	db->store->taxes_sum = db->header->taxes_sum;
+	db->store->is_mapped = true;
+	db->store->is_indexed = false;
+	company_store_build_indexes_later(db->store);
+
+	return db;
+};
+
+// Checkpoints when is_checkpointed is set, unmaps and frees the database.
+inline void close_company_database(CompanyDatabase * db, bool is_checkpointed){
+	if(is_checkpointed)
+		company_db_checkpoint_compacting(db);
+
+	// freeing the store waits for the index builder, which reads the mapping
+	if(db->store != NULL)
+		free_company_store(db->store);
+	if(db->wal != MAP_FAILED)
+		munmap(db->wal, db->wal_capacity);
+	if(db->data != MAP_FAILED)
+		munmap(db->data, db->data_size);
+	close(db->fd);
+	delete db->dirty_pages;
+	free(db->path);
+	free(db);
+};
+
+// Returns index of the new record, -1 when a record with the code exists or
+// the database can not get room for it.
+inline long company_db_add(CompanyDatabase * db, int code, int paid_taxes_amount, const char * name){
+	long names_length, index;
+
+	company_store_ensure_indexes(db->store);
+	if(company_store_find(db->store, code) >= 0 || !company_db_make_room(db, 1, strlen(name) + 1) ||
+		!company_db_reserve_wal(db, company_db_change_size(strlen(name))))
+		return -1;
+	names_length = db->store->names_length;
+
+	index = company_store_add(db->store, code, paid_taxes_amount, name);
+	if(index < 0)
+		return -1;
+
+	company_db_log_record(db, index);
+	company_db_log_lengths(db, names_length);
+	company_db_finish_change(db);
+
+	return index;
+};
+
+// Same as company_store_update_by_code, name NULL keeps the old one.
+inline bool company_db_update_by_code(CompanyDatabase * db, int code, int paid_taxes_amount, const char * name){
+	long name_length = name == NULL ? 0 : strlen(name) + 1;
+	long names_length, old_name_length, index;
+
+	company_store_ensure_indexes(db->store);
+	if(!company_db_make_room(db, 0, name_length))
+		return false;
+	index = company_store_find(db->store, code);
+	if(index < 0 || !company_db_reserve_wal(db, company_db_change_size(name_length)))
+		return false;
+
+	names_length = db->store->names_length;
+	old_name_length = strlen(company_store_name(db->store, index)) + 1;
+	if(!company_store_update(db->store, index, code, paid_taxes_amount, name))
+		return false;
+	if(name != NULL)
+		db->header->names_garbage += old_name_length;
+
+	company_db_log_record(db, index);
+	company_db_log_lengths(db, names_length);
+	company_db_finish_change(db);
+
+	return true;
+};
+
+inline bool company_db_remove_by_code(CompanyDatabase * db, int code){
+	long index = company_store_find(db->store, code);
+
+	if(index < 0 || !company_db_reserve_wal(db, company_db_change_size(0)))
+		return false;
+
+	db->header->names_garbage += strlen(company_store_name(db->store, index)) + 1;
+	company_store_remove(db->store, index);
+	if(index < db->store->length)
+		company_db_log_record(db, index);
+	company_db_log_lengths(db, db->store->names_length);
+	company_db_finish_change(db);
+
+	return true;
+};
+
+// Imports a CSV or binary file like company_store_import. Records are not
+// logged, they are written to the file after a checkpoint and become visible
+// with the header, so a crash keeps none or all of them. An import which
+// does not fit is tried again with room for as many records as the file can
+// hold, every record takes at least 4 bytes of it.
+inline long company_db_import(CompanyDatabase * db, const char * path){
+	CompanyStore * store = db->store;
+	long length = store->length, names_length = store->names_length;
+	struct stat file_stat;
+	long imported;
+
+	if(!company_db_checkpoint(db))
+		return -1;
+
+	imported = company_store_import(store, path);
+	if(imported < 0 && stat(path, &file_stat) == 0 &&
+		(store->length + file_stat.st_size / 4 + 1 > store->capacity || store->names_length + file_stat.st_size > store->names_capacity)){
+		if(!company_db_make_room(db, file_stat.st_size / 4 + 1, file_stat.st_size))
+			return -1;
+		length = store->length;
+		names_length = store->names_length;
+		imported = company_store_import(store, path);
+	}
+	if(imported <= 0)
+		return imported;
+
+	if(pwrite(db->fd, store->codes + length, imported * sizeof(int), db->header->codes_offset + length * sizeof(int)) != (long) (imported * sizeof(int)) ||
+		pwrite(db->fd, store->paid_taxes_amounts + length, imported * sizeof(int), db->header->paid_taxes_amounts_offset + length * sizeof(int)) != (long) (imported * sizeof(int)) ||
+		pwrite(db->fd, store->name_offsets + length, imported * sizeof(long), db->header->name_offsets_offset + length * sizeof(long)) != (long) (imported * sizeof(long)) ||
+		pwrite(db->fd, store->names + names_length, store->names_length - names_length, db->header->names_offset + names_length) != store->names_length - names_length ||
+		fdatasync(db->fd) != 0)
+		return -1;
+
+	db->header->length = store->length;
+	db->header->names_length = store->names_length;
+	db->header->taxes_sum = store->taxes_sum;
+	if(!company_db_write_header(db))
+		return -1;
+
+	return imported;
+};
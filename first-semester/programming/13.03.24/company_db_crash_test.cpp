@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <iostream>
+#include <string>
+#include "company_store.h"
+#include "company_db.h"
+
+// Kills a process which changes a company database at random moments and
+// opens the database after every kill. Changes are made in a fixed order, so
+// the records after a kill have to be the same as in a store in memory after
+// the changes the process finished, or after one more, a change is never seen
+// in part. The log and the first room for records and names are small, so
+// kills also hit checkpoints and copies of the database which grow it or drop
+// names of no record. A kill keeps every byte written to the shared log, but
+// lands between two of its records only by luck, so after the kills the log
+// of a process which stopped without a checkpoint is also cut after each of
+// its last records, which is where a kill in the middle of a change leaves
+// it, and every cut is opened.
+// Build: g++ -O2 company_db_crash_test.cpp -o company_db_crash_test
+// Usage: ./company_db_crash_test [kills] [database]
+
+#define CRASH_TEST_CHANGES 200000
+#define CRASH_TEST_CUTS 64
+
+// Applies change number i to db, or to store when db is NULL.
+void crash_test_change(CompanyDatabase * db, CompanyStore * store, long i){
+	unsigned int seed = i * 2654435761u + 83663;
+	int code = (int) (seed % 509), paid_taxes_amount = (int) (seed >> 9) % 100000;
+	std::string name = "company " + std::to_string(i);
+	const char * new_name = seed % 7 < 3 ? name.c_str() : NULL;
+
+	switch(seed % 5){
+		case 0:
+		case 1:
+			if(db)
+				company_db_add(db, code, paid_taxes_amount, name.c_str());
+			else
+				company_store_add(store, code, paid_taxes_amount, name.c_str());
+			break;
+		case 2:
+		case 3:
+			if(db)
+				company_db_update_by_code(db, code, paid_taxes_amount, new_name);
+			else
+				company_store_update_by_code(store, code, paid_taxes_amount, new_name);
+			break;
+		default:
+			if(db)
+				company_db_remove_by_code(db, code);
+			else
+				company_store_remove_by_code(store, code);
+	}
+};
+
+bool crash_test_is_same(CompanyStore * store, CompanyStore * expected){
+	if(store->length != expected->length || company_store_taxes_sum(store) != company_store_taxes_sum(expected))
+		return false;
+
+	for(long i = 0; i < store->length; i++)
+		if(store->codes[i] != expected->codes[i] || store->paid_taxes_amounts[i] != expected->paid_taxes_amounts[i] ||
+			store->name_offsets[i] < 0 || store->name_offsets[i] >= store->names_length ||
+			strcmp(company_store_name(store, i), company_store_name(expected, i)) != 0)
+			return false;
+
+	return true;
+};
+
+// Creates an empty database at path, false when it can not be created.
+bool crash_test_create(const char * path){
+	CompanyDatabase * db;
+
+	unlink(path);
+	db = open_company_database(path, 16, 256, 64 << 10);
+	if(db == NULL)
+		return false;
+	close_company_database(db, true);
+
+	return true;
+};
+
+// Advances expected by whole changes until it is the same as the database,
+// false when no amount of changes up to last makes it so.
+bool crash_test_match(CompanyStore * store, CompanyStore * expected, long * changes, long last){
+	while(!crash_test_is_same(store, expected)){
+		if(*changes == last)
+			return false;
+		crash_test_change(NULL, expected, (*changes)++);
+	}
+
+	return true;
+};
+
+// Runs changes without a checkpoint at the end, then opens copies of the
+// database with the log cut after each of its last records.
+bool crash_test_cut_log(const char * path, long change_amount){
+	std::string copy_path = std::string(path) + ".cut";
+	CompanyDatabaseHeader header;
+	std::vector<long> cuts;
+	std::vector<char> file;
+	struct stat file_stat;
+	int fd;
+
+	if(!crash_test_create(path))
+		return false;
+	if(fork() == 0){
+		CompanyDatabase * db = open_company_database(path, 0, 0, 0);
+		for(long i = 0; db != NULL && i < change_amount; i++)
+			crash_test_change(db, NULL, i);
+		company_db_commit(db);
+		_exit(0);
+	}
+	wait(NULL);
+
+	fd = open(path, O_RDONLY);
+	fstat(fd, &file_stat);
+	file.resize(file_stat.st_size);
+	if(pread(fd, file.data(), file.size(), 0) != (long) file.size())
+		return false;
+	close(fd);
+	memcpy(&header, file.data(), sizeof(header));
+
+	// boundaries of the valid records of the current generation
+	for(long position = 0; position + (long) sizeof(CompanyWalRecord) <= header.wal_capacity; ){
+		CompanyWalRecord * record = (CompanyWalRecord *) (file.data() + header.wal_offset + position);
+		if(record->sequence != header.checkpoint_sequence || record->size < 0 ||
+			record->checksum != company_db_checksum(record, (const char *) (record + 1)))
+			break;
+		cuts.push_back(position);
+		position += company_db_wal_record_size(record->size);
+	}
+	if(cuts.size() > CRASH_TEST_CUTS)
+		cuts.erase(cuts.begin(), cuts.end() - CRASH_TEST_CUTS);
+
+	CompanyStore * expected = get_company_store();
+	long changes = 0;
+	bool is_valid = true;
+
+	for(long cut : cuts){
+		std::vector<char> cut_file(file);
+		memset(cut_file.data() + header.wal_offset + cut, 0, header.wal_capacity - cut);
+
+		fd = open(copy_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if(fd < 0 || write(fd, cut_file.data(), cut_file.size()) != (long) cut_file.size() || close(fd) != 0)
+			return false;
+
+		CompanyDatabase * db = open_company_database(copy_path.c_str(), 0, 0, 0);
+		is_valid = db != NULL && crash_test_match(db->store, expected, &changes, change_amount);
+		if(db != NULL)
+			close_company_database(db, false);
+		if(!is_valid){
+			std::cout << "log cut at " << cut << " of " << change_amount << " changes: database is not the state after a whole change INVALID\n";
+			break;
+		}
+	}
+
+	free_company_store(expected);
+	unlink(copy_path.c_str());
+	unlink(path);
+
+	return is_valid;
+};
+
+int main(int argc, char ** argv){
+	long kill_amount = argc > 1 ? atol(argv[1]) : 100;
+	const char * path = argc > 2 ? argv[2] : "/tmp/company_db_crash_test.db";
+	// amount of changes the child finished, shared with it
+	volatile long * done = (volatile long *) mmap(NULL, sizeof(long), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	srand(83663);
+	for(long round = 0; round < kill_amount; round++){
+		CompanyDatabase * db;
+
+		if(!crash_test_create(path)){
+			std::cout << "Error: Can not create " << path << "\n";
+			return 1;
+		}
+		*done = 0;
+
+		pid_t child = fork();
+		if(child == 0){
+			db = open_company_database(path, 0, 0, 0);
+			for(long i = 0; db != NULL && i < CRASH_TEST_CHANGES; i++){
+				crash_test_change(db, NULL, i);
+				*done = i + 1;
+			}
+			_exit(0);
+		}
+		usleep(1000 + rand() % 50000);
+		kill(child, SIGKILL);
+		waitpid(child, NULL, 0);
+
+		db = open_company_database(path, 0, 0, 0);
+		if(db == NULL){
+			std::cout << "Error: Can not open database after kill " << round << "\n";
+			return 1;
+		}
+
+		// the change running at the kill may be complete in the log
+		CompanyStore * expected = get_company_store();
+		long finished = *done;
+		bool is_valid;
+
+		for(long i = 0; i < finished; i++)
+			crash_test_change(NULL, expected, i);
+		is_valid = crash_test_is_same(db->store, expected);
+		if(!is_valid){
+			crash_test_change(NULL, expected, finished);
+			is_valid = crash_test_is_same(db->store, expected);
+		}
+		free_company_store(expected);
+		close_company_database(db, false);
+
+		if(!is_valid){
+			std::cout << "kill " << round << " after " << finished << " changes: database is not the state after a whole change INVALID\n";
+			return 1;
+		}
+	}
+
+	unlink(path);
+	std::cout << kill_amount << " kills, every database was the state after whole changes, ok\n";
+
+	for(long change_amount : {1L, 2L, 3L, 10L, 777L, 5000L})
+		if(!crash_test_cut_log(path, change_amount))
+			return 1;
+	std::cout << "log cuts, every database was the state after whole changes, ok\n";
+
+	return 0;
+};
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <charconv>
+#include <thread>
+#include "company_store.h"
+
+// Bulk import and export of company records.
+//
+// CSV has one record per line: code,paid_taxes_amount,name. Name is the rest
+// of the line and may contain commas, "\r" before the line ending is dropped
+// and a first line starting with "code," is a header. Input is mapped with
+// mmap, delimiters are found 32 bytes at a time with AVX2 and numbers are
+// parsed with std::from_chars. Files of COMPANY_IO_PARALLEL_SIZE bytes or
+// more are split at line endings between threads, every thread parses its
+// part into its own columns and parts are appended in file order.
+//
+// Binary file is a header (magic "COMPANY1", record count, names size)
+// followed by the columns as they are in memory: codes, paid taxes amounts,
+// name offsets and names. Export of both formats goes through one
+// COMPANY_IO_BUFFER_SIZE buffer written with large write calls.
+
+#define COMPANY_IO_PARALLEL_SIZE (4L << 20)
+#define COMPANY_IO_BUFFER_SIZE (1L << 20)
+
+struct CompanyFileHeader {
+	char magic[8];
+	long length;
+	long names_length;
+};
+
+// Records parsed from one part of a CSV file, names point into the mapping.
+struct CompanyCsvPart {
+	const char * begin;
+	const char * end;
+	std::vector<int> codes;
+	std::vector<int> paid_taxes_amounts;
+	std::vector<const char *> names;
+	std::vector<int> name_lengths;
+	long names_length;
+	bool is_valid;
+};
+
+inline const char * company_io_find_delimiter_scalar(const char * p, const char * end, char delimiter){
+	while(p < end && *p != delimiter && *p != '\n')
+		p++;
+
+	return p;
+};
+
+#ifdef COMPANY_STORE_AVX2
+
+// First delimiter or line ending at or after p, end when there is none.
+__attribute__((target("avx2")))
+inline const char * company_io_find_delimiter_avx2(const char * p, const char * end, char delimiter){
+	const __m256i delimiters = _mm256_set1_epi8(delimiter);
+	const __m256i line_endings = _mm256_set1_epi8('\n');
+
+	for(; p + 32 <= end; p += 32){
+		__m256i block = _mm256_loadu_si256((const __m256i *) p);
+		unsigned int mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, delimiters), _mm256_cmpeq_epi8(block, line_endings)));
+		if(mask != 0)
+			return p + __builtin_ctz(mask);
+	}
+
+	return company_io_find_delimiter_scalar(p, end, delimiter);
+};
+
+#endif
+
+inline const char * company_io_find_delimiter(const char * p, const char * end, char delimiter){
+#ifdef COMPANY_STORE_AVX2
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if(has_avx2)
+		return company_io_find_delimiter_avx2(p, end, delimiter);
+#endif
+
+	return company_io_find_delimiter_scalar(p, end, delimiter);
+};
+
+// Reads the whole of [begin, end) as an int, false when it is not a number
+// or does not fit in int.
+inline bool company_io_parse_int(const char * begin, const char * end, int * value){
+	std::from_chars_result result = std::from_chars(begin, end, *value);
+
+	return result.ec == std::errc() && result.ptr == end;
+};
+
+// Name is searched with '\n' as delimiter, so commas stay in the name.
+inline void company_io_parse_csv_part(CompanyCsvPart * part){
+	const char * p = part->begin;
+	const char * end = part->end;
+
+	part->names_length = 0;
+	part->is_valid = true;
+
+	while(p < end){
+		int code, paid_taxes_amount;
+		const char * field_end = company_io_find_delimiter(p, end, ',');
+
+		if(*p == '\n' || (*p == '\r' && p + 1 < end && *(p + 1) == '\n')){
+			p += *p == '\n' ? 1 : 2;
+			continue;
+		}
+
+		if(field_end == end || *field_end != ',' || !company_io_parse_int(p, field_end, &code)){
+			part->is_valid = false;
+			return;
+		}
+		p = field_end + 1;
+
+		field_end = company_io_find_delimiter(p, end, ',');
+		if(field_end == end || *field_end != ',' || !company_io_parse_int(p, field_end, &paid_taxes_amount)){
+			part->is_valid = false;
+			return;
+		}
+		p = field_end + 1;
+
+		field_end = company_io_find_delimiter(p, end, '\n');
+		const char * name_end = field_end > p && *(field_end - 1) == '\r' ? field_end - 1 : field_end;
+
+		part->codes.push_back(code);
+		part->paid_taxes_amounts.push_back(paid_taxes_amount);
+		part->names.push_back(p);
+		part->name_lengths.push_back(name_end - p);
+		part->names_length += name_end - p + 1;
+
+		p = field_end < end ? field_end + 1 : end;
+	}
+};
+
+// True when codes of the parts are unique and not in the store yet and a
+// mapped store has room for all records and names.
+inline bool company_io_has_unique_codes(CompanyStore * store, std::vector<CompanyCsvPart> & parts){
+	std::vector<int> codes;
+	long names_length = 0;
+
+	company_store_ensure_indexes(store);
+
+	for(auto & part : parts)
+		names_length += part.names_length;
+
+	for(auto & part : parts)
+		codes.insert(codes.end(), part.codes.begin(), part.codes.end());
+	std::sort(codes.begin(), codes.end());
+
+	if(store->is_mapped && (store->length + (long) codes.size() > store->capacity || store->names_length + names_length > store->names_capacity))
+		return false;
+
+	if(std::adjacent_find(codes.begin(), codes.end()) != codes.end())
+		return false;
+	for(int code : codes)
+		if(company_store_find(store, code) >= 0)
+			return false;
+
+	return true;
+};
+
+// Appends columns of a part to the store, codes must be checked with
+// company_io_has_unique_codes. Indexes of an empty store are built from the
+// columns, which is linear.
+inline void company_io_append_part(CompanyStore * store, CompanyCsvPart * part){
+	long length = part->codes.size();
+	long first = store->length;
+
+	company_store_reserve(store, store->length + length);
+	if(store->names_length + part->names_length > store->names_capacity){
+		store->names_capacity = std::max(store->names_length + part->names_length, store->names_capacity * 2);
+		store->names = (char *) realloc(store->names, store->names_capacity);
+	}
+
+	for(long i = 0; i < length; i++){
+		long index = store->length + i;
+
+		store->codes[index] = part->codes[i];
+		store->paid_taxes_amounts[index] = part->paid_taxes_amounts[i];
+		store->name_offsets[index] = store->names_length;
+		memcpy(store->names + store->names_length, part->names[i], part->name_lengths[i]);
+		store->names[store->names_length + part->name_lengths[i]] = '\0';
+		store->names_length += part->name_lengths[i] + 1;
+
+		store->taxes_sum += part->paid_taxes_amounts[i];
+	}
+	store->length += length;
+
+	company_store_index_records(store, first);
+};
+
+// Returns amount of imported records, -1 when the file can not be read, has
+// a malformed line, a code which is already taken or does not fit a mapped
+// store, then the store is not changed.
+inline long company_store_import_csv(CompanyStore * store, const char * path){
+	int fd = open(path, O_RDONLY);
+	struct stat file_stat;
+	const char * data;
+	const char * begin;
+	const char * end;
+	long part_amount = 1, imported = 0;
+	bool is_valid = true;
+
+	if(fd < 0)
+		return -1;
+	if(fstat(fd, &file_stat) != 0){
+		close(fd);
+		return -1;
+	}
+	if(file_stat.st_size == 0){
+		close(fd);
+		return 0;
+	}
+
+	data = (const char *) mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+		return -1;
+	madvise((void *) data, file_stat.st_size, MADV_SEQUENTIAL);
+
+	begin = data;
+	end = data + file_stat.st_size;
+	if(file_stat.st_size >= 5 && memcmp(begin, "code,", 5) == 0){
+		begin = company_io_find_delimiter(begin, end, '\n');
+		begin = begin < end ? begin + 1 : end;
+	}
+
+	if(end - begin >= COMPANY_IO_PARALLEL_SIZE)
+		part_amount = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<CompanyCsvPart> parts(part_amount);
+	std::vector<std::thread> threads;
+
+	// parts end right after a line ending
+	for(long i = 0; i < part_amount; i++){
+		parts[i].begin = i == 0 ? begin : parts[i - 1].end;
+		parts[i].end = i == part_amount - 1 ? end : begin + (end - begin) * (i + 1) / part_amount;
+		if(parts[i].end < parts[i].begin)
+			parts[i].end = parts[i].begin;
+		if(parts[i].end < end && parts[i].end > parts[i].begin && *(parts[i].end - 1) != '\n'){
+			parts[i].end = company_io_find_delimiter(parts[i].end, end, '\n');
+			parts[i].end = parts[i].end < end ? parts[i].end + 1 : end;
+		}
+	}
+
+	for(long i = 1; i < part_amount; i++)
+		threads.push_back(std::thread(company_io_parse_csv_part, &parts[i]));
+	company_io_parse_csv_part(&parts[0]);
+	for(auto & thread : threads)
+		thread.join();
+
+	for(auto & part : parts)
+		is_valid = is_valid && part.is_valid;
+	is_valid = is_valid && company_io_has_unique_codes(store, parts);
+
+	if(is_valid){
+		for(auto & part : parts){
+			company_io_append_part(store, &part);
+			imported += part.codes.size();
+		}
+	}
+
+	munmap((void *) data, file_stat.st_size);
+
+	return is_valid ? imported : -1;
+};
+
+// Returns amount of imported records, -1 when the file is not a company
+// binary file, can not be read, has a code which is already taken or does
+// not fit a mapped store.
+inline long company_store_import_binary(CompanyStore * store, const char * path){
+	int fd = open(path, O_RDONLY);
+	struct stat file_stat;
+	const char * data;
+	CompanyFileHeader header;
+	long columns_size, size;
+	std::vector<CompanyCsvPart> parts(1);
+	CompanyCsvPart & part = parts[0];
+
+	if(fd < 0)
+		return -1;
+	if(fstat(fd, &file_stat) != 0 || file_stat.st_size < (long) sizeof(CompanyFileHeader)){
+		close(fd);
+		return -1;
+	}
+
+	data = (const char *) mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(data == MAP_FAILED)
+		return -1;
+	madvise((void *) data, file_stat.st_size, MADV_SEQUENTIAL);
+
+	memcpy(&header, data, sizeof(header));
+	if(memcmp(header.magic, "COMPANY1", 8) != 0 || header.length < 0 || header.names_length < 0 ||
+		__builtin_mul_overflow(header.length, (long) (2 * sizeof(int) + sizeof(long)), &columns_size) ||
+		__builtin_add_overflow(columns_size, header.names_length, &size) ||
+		__builtin_add_overflow(size, (long) sizeof(header), &size) || size != file_stat.st_size){
+		munmap((void *) data, file_stat.st_size);
+		return -1;
+	}
+
+	const int * codes = (const int *) (data + sizeof(header));
+	const int * paid_taxes_amounts = codes + header.length;
+	const long * name_offsets = (const long *) (paid_taxes_amounts + header.length);
+	const char * names = (const char *) (name_offsets + header.length);
+
+	part.codes.assign(codes, codes + header.length);
+	part.paid_taxes_amounts.assign(paid_taxes_amounts, paid_taxes_amounts + header.length);
+	part.names.resize(header.length);
+	part.name_lengths.resize(header.length);
+	part.names_length = 0;
+	for(long i = 0; i < header.length; i++){
+		if(name_offsets[i] < 0 || name_offsets[i] >= header.names_length ||
+			memchr(names + name_offsets[i], '\0', header.names_length - name_offsets[i]) == NULL){
+			munmap((void *) data, file_stat.st_size);
+			return -1;
+		}
+		part.names[i] = names + name_offsets[i];
+		part.name_lengths[i] = strlen(part.names[i]);
+		part.names_length += part.name_lengths[i] + 1;
+	}
+
+	if(!company_io_has_unique_codes(store, parts)){
+		munmap((void *) data, file_stat.st_size);
+		return -1;
+	}
+	company_io_append_part(store, &part);
+	munmap((void *) data, file_stat.st_size);
+
+	return header.length;
+};
+
+// Binary files start with the magic, everything else is read as CSV.
+inline long company_store_import(CompanyStore * store, const char * path){
+	char magic[8];
+	int fd = open(path, O_RDONLY);
+	bool is_binary;
+
+	if(fd < 0)
+		return -1;
+	is_binary = read(fd, magic, 8) == 8 && memcmp(magic, "COMPANY1", 8) == 0;
+	close(fd);
+
+	return is_binary ? company_store_import_binary(store, path) : company_store_import_csv(store, path);
+};
+
+struct CompanyWriter {
+	int fd;
+	char * buffer;
+	long length;
+	bool is_valid;
+};
+
+inline void company_writer_flush(CompanyWriter * writer){
+	long written = 0;
+
+	while(writer->is_valid && written < writer->length){
+		long result = write(writer->fd, writer->buffer + written, writer->length - written);
+		if(result <= 0)
+			writer->is_valid = false;
+		else
+			written += result;
+	}
+	writer->length = 0;
+};
+
+inline void company_writer_write(CompanyWriter * writer, const void * data, long length){
+	const char * bytes = (const char *) data;
+
+	while(length > 0){
+		long part = std::min(length, COMPANY_IO_BUFFER_SIZE - writer->length);
+		memcpy(writer->buffer + writer->length, bytes, part);
+		writer->length += part;
+		bytes += part;
+		length -= part;
+		if(writer->length == COMPANY_IO_BUFFER_SIZE)
+			company_writer_flush(writer);
+	}
+};
+
+inline bool company_writer_open(CompanyWriter * writer, const char * path){
+	writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	writer->buffer = (char *) malloc(COMPANY_IO_BUFFER_SIZE);
+	writer->length = 0;
+	writer->is_valid = writer->fd >= 0;
+
+	return writer->is_valid;
+};
+
+inline bool company_writer_close(CompanyWriter * writer){
+	company_writer_flush(writer);
+	if(writer->fd >= 0 && close(writer->fd) != 0)
+		writer->is_valid = false;
+	free(writer->buffer);
+
+	return writer->is_valid;
+};
+
+// Returns false when the file can not be written.
+inline bool company_store_export_csv(CompanyStore * store, const char * path){
+	CompanyWriter writer;
+	char number[16];
+
+	if(!company_writer_open(&writer, path)){
+		company_writer_close(&writer);
+		return false;
+	}
+
+	company_writer_write(&writer, "code,paid_taxes_amount,name\n", 28);
+	for(long i = 0; i < store->length; i++){
+		char * name = company_store_name(store, i);
+
+		company_writer_write(&writer, number, std::to_chars(number, number + sizeof(number), store->codes[i]).ptr - number);
+		company_writer_write(&writer, ",", 1);
+		company_writer_write(&writer, number, std::to_chars(number, number + sizeof(number), store->paid_taxes_amounts[i]).ptr - number);
+		company_writer_write(&writer, ",", 1);
+		company_writer_write(&writer, name, strlen(name));
+		company_writer_write(&writer, "\n", 1);
+	}
+
+	return company_writer_close(&writer);
+};
+
+// Names are written without the ones left in the arena by update and
+// remove, so offsets in the file are computed again.
+inline bool company_store_export_binary(CompanyStore * store, const char * path){
+	CompanyWriter writer;
+	CompanyFileHeader header;
+	long name_offset = 0;
+
+	if(!company_writer_open(&writer, path)){
+		company_writer_close(&writer);
+		return false;
+	}
+
+	memcpy(header.magic, "COMPANY1", 8);
+	header.length = store->length;
+	header.names_length = 0;
+	for(long i = 0; i < store->length; i++)
+		header.names_length += strlen(company_store_name(store, i)) + 1;
+
+	company_writer_write(&writer, &header, sizeof(header));
+	company_writer_write(&writer, store->codes, store->length * sizeof(int));
+	company_writer_write(&writer, store->paid_taxes_amounts, store->length * sizeof(int));
+	for(long i = 0; i < store->length; i++){
+		company_writer_write(&writer, &name_offset, sizeof(long));
+		name_offset += strlen(company_store_name(store, i)) + 1;
+	}
+	for(long i = 0; i < store->length; i++){
+		char * name = company_store_name(store, i);
+		company_writer_write(&writer, name, strlen(name) + 1);
+	}
+
+	return company_writer_close(&writer);
+};
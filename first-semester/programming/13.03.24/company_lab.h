@@ -0,0 +1,182 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "company_store.h"
+#include "company_io.h"
+#include "company_db.h"
+
+// Menu of the company labs. Structure fields: company code, name, paid
+// taxes amount. Operation: define company name that paid lowest taxes amount.
+// Records are read from company_store, changes go through company_db when it
+// is not NULL, so they are logged to the database file, otherwise they are
+// made in the store in memory.
+
+inline void print_task_number(){
+	int student_code = 83663;
+	int amount_of_tasks = 20;
+	int task_number = student_code % amount_of_tasks;
+
+	std::cout << "Task number: " <<  task_number << "\n";
+};
+
+inline void print_company(Company * c){
+	std::cout << "name: " << c->name << "\n"
+		<< "code:" << c->code << "\n"
+		<< "paid_taxes_amount:" << c->paid_taxes_amount << "\n"
+		<< "=======================\n";
+};
+
+inline void get_company_data(int * code, int * paid_taxes_amount, char * name) {
+	std::cout << "Type company code: ";
+	std::cin >> *code;
+
+	std::cout << "Type company paid_taxes_amount: ";
+	std::cin >> *paid_taxes_amount;
+
+	// name buffer holds 100 characters with the terminator
+	std::cout << "Type company name: ";
+	std::cin >> std::setw(100) >> name;
+};
+
+inline void run_company_lab(CompanyStore * company_store, CompanyDatabase * company_db){
+	print_task_number();
+
+	int exit = false;
+	int operation_code = 0;
+
+	while(exit == false){
+		std::cout << "Please type operation code number: \n"
+			<< "0 - Exit.\n"
+			<< "1 - Add company record.\n"
+			<< "2 - Print all records of companies.\n"
+			<< "3 - Define company name that paid lowest taxes amount.\n"
+			<< "4 - Define company name that paid highest taxes amount.\n"
+			<< "5 - Print paid taxes sum and amount of companies.\n"
+			<< "6 - Print k companies that paid lowest taxes amount.\n"
+			<< "7 - Print k companies that paid highest taxes amount.\n"
+			<< "8 - Import companies from CSV or binary file.\n"
+			<< "9 - Export companies to CSV file.\n"
+			<< "10 - Export companies to binary file.\n"
+			<< "11 - Find company by code.\n"
+			<< "12 - Update company by code.\n"
+			<< "13 - Delete company by code.\n"
+			<< "14 - Print companies with codes in range.\n";
+
+		std::cin >> operation_code;
+
+		int code, paid_taxes_amount;
+		char name[100];
+		Company company;
+		std::vector<long> companies;
+		long k, imported, index;
+		int last_code;
+		std::string path;
+
+		switch(operation_code){
+			case 0:
+				exit = true;
+				break;
+			case 1:
+				get_company_data(&code, &paid_taxes_amount, name);
+				if((company_db ? company_db_add(company_db, code, paid_taxes_amount, name) : company_store_add(company_store, code, paid_taxes_amount, name)) < 0)
+					std::cout << "Error: Company with this code already exists or database is full\n";
+				break;
+
+			case 2:
+				for(long i = 0; i < company_store->length; i++){
+					company = company_store_get(company_store, i);
+					print_company(&company);
+				}
+				break;
+
+			case 3:
+			case 4:
+				companies = operation_code == 3 ? company_store_lowest_taxes_ties(company_store) : company_store_highest_taxes_ties(company_store);
+				if(companies.size() > 0){
+					std::cout << (operation_code == 3 ? "Companies which paid lowest taxes amount: \n" : "Companies which paid highest taxes amount: \n");
+					for(long i : companies){
+						company = company_store_get(company_store, i);
+						print_company(&company);
+					}
+				} else {
+					std::cout << "Error: Database is empty\n";
+				}
+				break;
+
+			case 5:
+				std::cout << "Paid taxes sum: " << company_store_taxes_sum(company_store) << "\n"
+					<< "Amount of companies: " << company_store->length << "\n";
+				break;
+
+			case 6:
+			case 7:
+				std::cout << "Type k: ";
+				std::cin >> k;
+				companies = operation_code == 6 ? company_store_lowest_k(company_store, k) : company_store_highest_k(company_store, k);
+				for(long i : companies){
+					company = company_store_get(company_store, i);
+					print_company(&company);
+				}
+				break;
+
+			case 8:
+				std::cout << "Type file path: ";
+				std::cin >> path;
+				imported = company_db ? company_db_import(company_db, path.c_str()) : company_store_import(company_store, path.c_str());
+				if(imported >= 0)
+					std::cout << "Imported companies: " << imported << "\n";
+				else
+					std::cout << "Error: Can not import file\n";
+				break;
+
+			case 9:
+			case 10:
+				std::cout << "Type file path: ";
+				std::cin >> path;
+				if(!(operation_code == 9 ? company_store_export_csv(company_store, path.c_str()) : company_store_export_binary(company_store, path.c_str())))
+					std::cout << "Error: Can not export file\n";
+				break;
+
+			case 11:
+				std::cout << "Type company code: ";
+				std::cin >> code;
+				index = company_store_find(company_store, code);
+				if(index >= 0){
+					company = company_store_get(company_store, index);
+					print_company(&company);
+				} else {
+					std::cout << "Error: Company not found\n";
+				}
+				break;
+
+			case 12:
+				get_company_data(&code, &paid_taxes_amount, name);
+				if(!(company_db ? company_db_update_by_code(company_db, code, paid_taxes_amount, name) : company_store_update_by_code(company_store, code, paid_taxes_amount, name)))
+					std::cout << "Error: Company not found\n";
+				break;
+
+			case 13:
+				std::cout << "Type company code: ";
+				std::cin >> code;
+				if(!(company_db ? company_db_remove_by_code(company_db, code) : company_store_remove_by_code(company_store, code)))
+					std::cout << "Error: Company not found\n";
+				break;
+
+			case 14:
+				std::cout << "Type first and last company code: ";
+				std::cin >> code >> last_code;
+				for(long i : company_store_code_range(company_store, code, last_code)){
+					company = company_store_get(company_store, i);
+					print_company(&company);
+				}
+				break;
+
+			default:
+				exit = true;
+				break;
+		}
+
+	}
+};
@@ -0,0 +1,702 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define COMPANY_STORE_AVX2
+#endif
+
+// Company records kept as columns (struct of arrays). Codes and paid taxes
+// amounts are separate contiguous arrays, names are stored one after another
+// in one arena and a record keeps only the offset of its name. All columns
+// grow twice when full. Tax column is 32-byte aligned for AVX2 loads.
+//
+// Aggregates over paid taxes amounts are kept up to date by add, update and
+// remove: lowest_taxes and highest_taxes are binary heaps of all records, so
+// the lowest and highest amounts are on their tops, their ties are read
+// from the tops down and the k lowest or highest records in O(k log k),
+// taxes_sum is the running sum. Heaps hold only record indexes and
+// positions, 32 bytes per record.
+//
+// Code is the key of a record, code_slots is an open addressing table of
+// record indexes with linear probing, so records are found, updated and
+// removed by code in O(1). It is at most half full, 16 to 32 bytes per
+// record. Codes are not kept in order, a range of codes is read by scanning
+// the code column. A store can start with is_indexed false, like a store
+// whose columns are mapped from a database file, then both indexes are
+// built from the columns in O(n) on the first change or query which needs
+// them, or in another thread started by company_store_build_indexes_later,
+// then company_store_ensure_indexes waits for it. Until then a code is found
+// and the lowest and highest amounts are read by scanning the columns,
+// taxes_sum has to be set by whoever made the store, it is kept up to date
+// without the indexes too.
+//
+// Columns of a store with is_mapped set belong to somebody else and have
+// fixed capacity, adding records or names past it fails instead of growing.
+
+struct Company {
+	int code;
+	int paid_taxes_amount;
+	char * name;
+};
+
+// Binary heap of record indexes ordered by (paid taxes amount, index), the
+// lowest pair on top, or the highest one when is_highest is set. Record i is
+// at records[positions[i]], so a changed record is moved from its place.
+struct CompanyTaxesHeap {
+	std::vector<long> records;
+	std::vector<long> positions;
+	bool is_highest;
+};
+
+struct CompanyStore {
+	int * codes;
+	int * paid_taxes_amounts;
+	long * name_offsets;
+	char * names;
+	long length;
+	long capacity;
+	long names_length;
+	long names_capacity;
+	CompanyTaxesHeap * lowest_taxes;
+	CompanyTaxesHeap * highest_taxes;
+	long long taxes_sum;
+	std::vector<long> * code_slots;
+	std::thread * index_builder;
+	bool is_indexed;
+	bool is_mapped;
+};
+
+inline CompanyStore * get_company_store(){
+	CompanyStore * store = (CompanyStore *) malloc(sizeof(CompanyStore));
+
+	store->codes = NULL;
+	store->paid_taxes_amounts = NULL;
+	store->name_offsets = NULL;
+	store->names = NULL;
+	store->length = 0;
+	store->capacity = 0;
+	store->names_length = 0;
+	store->names_capacity = 0;
+	store->lowest_taxes = new CompanyTaxesHeap();
+	store->lowest_taxes->is_highest = false;
+	store->highest_taxes = new CompanyTaxesHeap();
+	store->highest_taxes->is_highest = true;
+	store->taxes_sum = 0;
+	store->code_slots = new std::vector<long>(16, -1);
+	store->index_builder = NULL;
+	store->is_indexed = true;
+	store->is_mapped = false;
+
+	return store;
+};
+
+// True when record a goes above record b in the heap.
+inline bool company_heap_is_above(CompanyTaxesHeap * heap, const int * amounts, long a, long b){
+	if(amounts[a] != amounts[b])
+		return heap->is_highest ? amounts[a] > amounts[b] : amounts[a] < amounts[b];
+
+	return heap->is_highest ? a > b : a < b;
+};
+
+inline void company_heap_place(CompanyTaxesHeap * heap, long position, long index){
+	heap->records[position] = index;
+	heap->positions[index] = position;
+};
+
+// Moves the record at position up while it goes above its parent, returns
+// its new position.
+inline long company_heap_sift_up(CompanyTaxesHeap * heap, const int * amounts, long position){
+	long index = heap->records[position];
+
+	while(position > 0 && company_heap_is_above(heap, amounts, index, heap->records[(position - 1) / 2])){
+		company_heap_place(heap, position, heap->records[(position - 1) / 2]);
+		position = (position - 1) / 2;
+	}
+	company_heap_place(heap, position, index);
+
+	return position;
+};
+
+// Moves the record at position down while one of its children goes above it.
+inline void company_heap_sift_down(CompanyTaxesHeap * heap, const int * amounts, long position){
+	long index = heap->records[position];
+	long length = heap->records.size();
+
+	for(long child; (child = 2 * position + 1) < length; position = child){
+		if(child + 1 < length && company_heap_is_above(heap, amounts, heap->records[child + 1], heap->records[child]))
+			child++;
+		if(!company_heap_is_above(heap, amounts, heap->records[child], index))
+			break;
+		company_heap_place(heap, position, heap->records[child]);
+	}
+	company_heap_place(heap, position, index);
+};
+
+// Puts the record at position in its place after its amount or index changed.
+inline void company_heap_fix(CompanyTaxesHeap * heap, const int * amounts, long position){
+	company_heap_sift_down(heap, amounts, company_heap_sift_up(heap, amounts, position));
+};
+
+// Makes a heap of records 0 to length - 1 bottom up, which is O(n).
+inline void company_heap_build(CompanyTaxesHeap * heap, const int * amounts, long length){
+	heap->records.resize(length);
+	heap->positions.resize(length);
+	for(long i = 0; i < length; i++)
+		company_heap_place(heap, i, i);
+	for(long i = length / 2 - 1; i >= 0; i--)
+		company_heap_sift_down(heap, amounts, i);
+};
+
+// Adds record index, which is the next record of the store.
+inline void company_heap_push(CompanyTaxesHeap * heap, const int * amounts, long index){
+	heap->records.push_back(index);
+	heap->positions.resize(index + 1);
+	heap->positions[index] = heap->records.size() - 1;
+	company_heap_sift_up(heap, amounts, heap->records.size() - 1);
+};
+
+// Takes record index out of the heap, the last record of the heap takes its
+// place.
+inline void company_heap_erase(CompanyTaxesHeap * heap, const int * amounts, long index){
+	long position = heap->positions[index];
+	long last = heap->records.back();
+
+	heap->records.pop_back();
+	if(position < (long) heap->records.size()){
+		company_heap_place(heap, position, last);
+		company_heap_fix(heap, amounts, position);
+	}
+};
+
+// Record from, the last record of the store, got index to, which is not in
+// the heap. Amount of to has to be the amount of from already.
+inline void company_heap_move(CompanyTaxesHeap * heap, const int * amounts, long from, long to){
+	company_heap_place(heap, heap->positions[from], to);
+	heap->positions.pop_back();
+	company_heap_fix(heap, amounts, heap->positions[to]);
+};
+
+// Records with the amount of the top, in order of indexes or in reverse
+// order for a heap of the highest. A record with another amount has only
+// other amounts below it, so the walk stops there.
+inline std::vector<long> company_heap_top_ties(CompanyTaxesHeap * heap, const int * amounts){
+	std::vector<long> indexes, positions;
+	long length = heap->records.size();
+
+	if(length == 0)
+		return indexes;
+	positions.push_back(0);
+	while(!positions.empty()){
+		long position = positions.back();
+
+		positions.pop_back();
+		if(position >= length || amounts[heap->records[position]] != amounts[heap->records[0]])
+			continue;
+		indexes.push_back(heap->records[position]);
+		positions.push_back(2 * position + 1);
+		positions.push_back(2 * position + 2);
+	}
+	std::sort(indexes.begin(), indexes.end());
+	if(heap->is_highest)
+		std::reverse(indexes.begin(), indexes.end());
+
+	return indexes;
+};
+
+// First k records of the heap in its order. Candidates are children of
+// records taken so far, a record is taken only after its parent, so k records
+// cost O(k log k).
+inline std::vector<long> company_heap_top_k(CompanyTaxesHeap * heap, const int * amounts, long k){
+	std::vector<long> indexes;
+	long length = heap->records.size();
+	auto is_below = [heap, amounts](long a, long b){
+		return company_heap_is_above(heap, amounts, heap->records[b], heap->records[a]);
+	};
+	std::priority_queue<long, std::vector<long>, decltype(is_below)> candidates(is_below);
+
+	if(length > 0)
+		candidates.push(0);
+	while(!candidates.empty() && (long) indexes.size() < k){
+		long position = candidates.top();
+
+		candidates.pop();
+		indexes.push_back(heap->records[position]);
+		for(long child = 2 * position + 1; child <= 2 * position + 2 && child < length; child++)
+			candidates.push(child);
+	}
+
+	return indexes;
+};
+
+// Fibonacci hashing, high half of the product depends on every bit of the code.
+inline long company_store_code_hash(int code){
+	return (long) (((uint64_t) (uint32_t) code * 0x9e3779b97f4a7c15ULL) >> 32);
+};
+
+// Slot of the record with the code, or the empty slot where it would be
+// added.
+inline long company_store_code_slot(CompanyStore * store, int code){
+	std::vector<long> & slots = *store->code_slots;
+	long mask = slots.size() - 1;
+	long slot = company_store_code_hash(code) & mask;
+
+	while(slots[slot] >= 0 && store->codes[slots[slot]] != code)
+		slot = (slot + 1) & mask;
+
+	return slot;
+};
+
+// Fills code slots with all records, there are enough slots to stay at most
+// half full with capacity records.
+inline void company_store_build_code_slots(CompanyStore * store, long capacity){
+	long slot_amount = 16;
+
+	while(slot_amount < 2 * capacity)
+		slot_amount *= 2;
+	store->code_slots->assign(slot_amount, -1);
+	for(long i = 0; i < store->length; i++)
+		(*store->code_slots)[company_store_code_slot(store, store->codes[i])] = i;
+};
+
+// Empties the slot of the code. Records after it in the same run are moved
+// back into the gap when the gap is between their home slot and their slot,
+// so every record stays reachable from its home slot.
+inline void company_store_erase_code(CompanyStore * store, int code){
+	std::vector<long> & slots = *store->code_slots;
+	long mask = slots.size() - 1;
+	long slot = company_store_code_slot(store, code);
+
+	for(long next = (slot + 1) & mask; slots[next] >= 0; next = (next + 1) & mask){
+		long home = company_store_code_hash(store->codes[slots[next]]) & mask;
+
+		if(((next - home) & mask) >= ((next - slot) & mask)){
+			slots[slot] = slots[next];
+			slot = next;
+		}
+	}
+	slots[slot] = -1;
+};
+
+// Builds both indexes from the columns, codes have to be unique.
+inline void company_store_build_indexes(CompanyStore * store){
+	company_heap_build(store->lowest_taxes, store->paid_taxes_amounts, store->length);
+	company_heap_build(store->highest_taxes, store->paid_taxes_amounts, store->length);
+	company_store_build_code_slots(store, store->length);
+};
+
+// Starts building the indexes of a store with is_indexed false in another
+// thread. The thread only reads the columns and fills the indexes, which the
+// store does not use until company_store_ensure_indexes takes them, so
+// queries scan the columns meanwhile. Every change takes them first.
+inline void company_store_build_indexes_later(CompanyStore * store){
+	if(!store->is_indexed && store->index_builder == NULL)
+		store->index_builder = new std::thread(company_store_build_indexes, store);
+};
+
+// Builds the indexes or waits for the thread building them. Changes the
+// store, so it is locked like for a change.
+inline void company_store_ensure_indexes(CompanyStore * store){
+	if(store->is_indexed)
+		return;
+
+	if(store->index_builder != NULL){
+		store->index_builder->join();
+		delete store->index_builder;
+		store->index_builder = NULL;
+	} else {
+		company_store_build_indexes(store);
+	}
+	store->is_indexed = true;
+};
+
+// Adds records from first to the end of the columns to the indexes, codes
+// have to be unique. Indexes are built again when the records are most of
+// the store.
+inline void company_store_index_records(CompanyStore * store, long first){
+	if(2 * first < store->length){
+		company_store_build_indexes(store);
+		return;
+	}
+
+	if(2 * store->length > (long) store->code_slots->size())
+		company_store_build_code_slots(store, store->length);
+	else
+		for(long i = first; i < store->length; i++)
+			(*store->code_slots)[company_store_code_slot(store, store->codes[i])] = i;
+	for(long i = first; i < store->length; i++){
+		company_heap_push(store->lowest_taxes, store->paid_taxes_amounts, i);
+		company_heap_push(store->highest_taxes, store->paid_taxes_amounts, i);
+	}
+};
+
+inline void * company_store_grow_aligned(void * column, long length, long capacity, size_t item_size){
+	size_t size = (capacity * item_size + 31) / 32 * 32;
+	void * new_column = aligned_alloc(32, size);
+
+	if(column != NULL){
+		memcpy(new_column, column, length * item_size);
+		free(column);
+	}
+
+	return new_column;
+};
+
+inline void company_store_reserve(CompanyStore * store, long capacity){
+	if(capacity <= store->capacity || store->is_mapped)
+		return;
+
+	store->codes = (int *) realloc(store->codes, capacity * sizeof(int));
+	store->paid_taxes_amounts = (int *) company_store_grow_aligned(store->paid_taxes_amounts, store->length, capacity, sizeof(int));
+	store->name_offsets = (long *) realloc(store->name_offsets, capacity * sizeof(long));
+	store->capacity = capacity;
+};
+
+// Copies name to the end of the arena, returns its offset or -1 when a
+// mapped arena is full.
+inline long company_store_add_name(CompanyStore * store, const char * name){
+	long name_length = strlen(name) + 1;
+	long name_offset = store->names_length;
+
+	if(store->is_mapped && store->names_length + name_length > store->names_capacity)
+		return -1;
+
+	if(store->names_length + name_length > store->names_capacity){
+		while(store->names_length + name_length > store->names_capacity)
+			store->names_capacity = store->names_capacity ? store->names_capacity * 2 : 1024;
+		store->names = (char *) realloc(store->names, store->names_capacity);
+	}
+
+	memcpy(store->names + store->names_length, name, name_length);
+	store->names_length += name_length;
+
+	return name_offset;
+};
+
+// Returns index of the new record, -1 when a record with the code exists
+// or a mapped store is full.
+inline long company_store_add(CompanyStore * store, int code, int paid_taxes_amount, const char * name){
+	company_store_ensure_indexes(store);
+
+	if(store->is_mapped && (store->length == store->capacity || store->names_length + (long) strlen(name) + 1 > store->names_capacity))
+		return -1;
+	if(2 * (store->length + 1) > (long) store->code_slots->size())
+		company_store_build_code_slots(store, store->length + 1);
+
+	long slot = company_store_code_slot(store, code);
+
+	if((*store->code_slots)[slot] >= 0)
+		return -1;
+	(*store->code_slots)[slot] = store->length;
+
+	if(store->length == store->capacity)
+		company_store_reserve(store, store->capacity ? store->capacity * 2 : 64);
+
+	store->codes[store->length] = code;
+	store->paid_taxes_amounts[store->length] = paid_taxes_amount;
+	store->name_offsets[store->length] = company_store_add_name(store, name);
+
+	company_heap_push(store->lowest_taxes, store->paid_taxes_amounts, store->length);
+	company_heap_push(store->highest_taxes, store->paid_taxes_amounts, store->length);
+	store->taxes_sum += paid_taxes_amount;
+
+	return store->length++;
+};
+
+// Changes code and paid taxes amount of a record, name is changed when it
+// is not NULL. Old name stays in the arena. Returns false when another
+// record has the new code or a mapped arena has no room for the name.
+inline bool company_store_update(CompanyStore * store, long index, int code, int paid_taxes_amount, const char * name){
+	company_store_ensure_indexes(store);
+
+	if(name != NULL && store->is_mapped && store->names_length + (long) strlen(name) + 1 > store->names_capacity)
+		return false;
+
+	if(code != store->codes[index]){
+		if((*store->code_slots)[company_store_code_slot(store, code)] >= 0)
+			return false;
+		company_store_erase_code(store, store->codes[index]);
+		store->codes[index] = code;
+		(*store->code_slots)[company_store_code_slot(store, code)] = index;
+	}
+
+	store->taxes_sum += (long long) paid_taxes_amount - store->paid_taxes_amounts[index];
+	store->paid_taxes_amounts[index] = paid_taxes_amount;
+	company_heap_fix(store->lowest_taxes, store->paid_taxes_amounts, store->lowest_taxes->positions[index]);
+	company_heap_fix(store->highest_taxes, store->paid_taxes_amounts, store->highest_taxes->positions[index]);
+	if(name != NULL)
+		store->name_offsets[index] = company_store_add_name(store, name);
+
+	return true;
+};
+
+// Removes a record by moving the last record in its place, so indexes of
+// other records do not change except the last one. Name stays in the arena.
+inline void company_store_remove(CompanyStore * store, long index){
+	long last = store->length - 1;
+
+	company_store_ensure_indexes(store);
+
+	company_heap_erase(store->lowest_taxes, store->paid_taxes_amounts, index);
+	company_heap_erase(store->highest_taxes, store->paid_taxes_amounts, index);
+	store->taxes_sum -= store->paid_taxes_amounts[index];
+	company_store_erase_code(store, store->codes[index]);
+
+	if(index != last){
+		(*store->code_slots)[company_store_code_slot(store, store->codes[last])] = index;
+
+		store->codes[index] = store->codes[last];
+		store->paid_taxes_amounts[index] = store->paid_taxes_amounts[last];
+		store->name_offsets[index] = store->name_offsets[last];
+
+		company_heap_move(store->lowest_taxes, store->paid_taxes_amounts, last, index);
+		company_heap_move(store->highest_taxes, store->paid_taxes_amounts, last, index);
+	} else {
+		store->lowest_taxes->positions.pop_back();
+		store->highest_taxes->positions.pop_back();
+	}
+
+	store->length--;
+};
+
+// Index of the record with the code, -1 when there is none. Without the
+// code index the code column is scanned.
+inline long company_store_find(CompanyStore * store, int code){
+	if(!store->is_indexed){
+		for(long i = 0; i < store->length; i++)
+			if(store->codes[i] == code)
+				return i;
+		return -1;
+	}
+
+	return (*store->code_slots)[company_store_code_slot(store, code)];
+};
+
+// Returns false when there is no record with the code.
+inline bool company_store_update_by_code(CompanyStore * store, int code, int paid_taxes_amount, const char * name){
+	long index = company_store_find(store, code);
+
+	return index >= 0 && company_store_update(store, index, code, paid_taxes_amount, name);
+};
+
+// Returns false when there is no record with the code.
+inline bool company_store_remove_by_code(CompanyStore * store, int code){
+	long index = company_store_find(store, code);
+
+	if(index < 0)
+		return false;
+
+	company_store_remove(store, index);
+	return true;
+};
+
+// Indexes of records with codes from first_code to last_code inclusive, in
+// order of codes. The code column is scanned, only the records in the range
+// are sorted.
+inline std::vector<long> company_store_code_range(CompanyStore * store, int first_code, int last_code){
+	std::vector<std::pair<int, long>> pairs;
+	std::vector<long> indexes;
+
+	for(long i = 0; i < store->length; i++)
+		if(store->codes[i] >= first_code && store->codes[i] <= last_code)
+			pairs.push_back(std::make_pair(store->codes[i], i));
+	std::sort(pairs.begin(), pairs.end());
+	for(auto & pair : pairs)
+		indexes.push_back(pair.second);
+
+	return indexes;
+};
+
+inline char * company_store_name(CompanyStore * store, long index){
+	return store->names + store->name_offsets[index];
+};
+
+// Record as a Company, name points into the arena and is valid until the
+// next add.
+inline Company company_store_get(CompanyStore * store, long index){
+	Company company = {
+		.code = store->codes[index],
+		.paid_taxes_amount = store->paid_taxes_amounts[index],
+		.name = company_store_name(store, index)
+	};
+
+	return company;
+};
+
+inline long company_store_lowest_taxes_scalar(const int * taxes, long length){
+	long lowest = 0;
+
+	for(long i = 1; i < length; i++)
+		if(taxes[i] < taxes[lowest])
+			lowest = i;
+
+	return lowest;
+};
+
+#ifdef COMPANY_STORE_AVX2
+
+// First pass finds the minimum with four independent vpminsd chains, second
+// pass finds the first record with that amount by comparing 8 amounts at a
+// time, so ties resolve to the earliest record like the scalar loop.
+__attribute__((target("avx2")))
+inline long company_store_lowest_taxes_avx2(const int * taxes, long length){
+	__m256i min0 = _mm256_set1_epi32(INT32_MAX), min1 = min0, min2 = min0, min3 = min0;
+	int lowest_amount = INT32_MAX;
+	long i = 0;
+
+	for(; i + 32 <= length; i += 32){
+		min0 = _mm256_min_epi32(min0, _mm256_load_si256((const __m256i *)(taxes + i)));
+		min1 = _mm256_min_epi32(min1, _mm256_load_si256((const __m256i *)(taxes + i + 8)));
+		min2 = _mm256_min_epi32(min2, _mm256_load_si256((const __m256i *)(taxes + i + 16)));
+		min3 = _mm256_min_epi32(min3, _mm256_load_si256((const __m256i *)(taxes + i + 24)));
+	}
+	min0 = _mm256_min_epi32(_mm256_min_epi32(min0, min1), _mm256_min_epi32(min2, min3));
+
+	__m128i min = _mm_min_epi32(_mm256_castsi256_si128(min0), _mm256_extracti128_si256(min0, 1));
+	min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+	min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+	lowest_amount = _mm_cvtsi128_si32(min);
+
+	for(; i < length; i++)
+		if(taxes[i] < lowest_amount)
+			lowest_amount = taxes[i];
+
+	__m256i needle = _mm256_set1_epi32(lowest_amount);
+	for(i = 0; i + 8 <= length; i += 8){
+		int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_load_si256((const __m256i *)(taxes + i)), needle)));
+		if(mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+	for(; taxes[i] != lowest_amount; i++);
+
+	return i;
+};
+
+#endif
+
+// Scans tax column for the record with the lowest paid taxes amount, the
+// first one when several records have it, -1 for an empty store. AVX2
+// kernel is used when the CPU supports it.
+inline long company_store_scan_lowest_taxes(CompanyStore * store){
+	if(store->length == 0)
+		return -1;
+
+#ifdef COMPANY_STORE_AVX2
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if(has_avx2)
+		return company_store_lowest_taxes_avx2(store->paid_taxes_amounts, store->length);
+#endif
+
+	return company_store_lowest_taxes_scalar(store->paid_taxes_amounts, store->length);
+};
+
+// Scans tax column for the record with the highest paid taxes amount, the
+// last one when several records have it, -1 for an empty store.
+inline long company_store_scan_highest_taxes(CompanyStore * store){
+	long highest = store->length - 1;
+
+	for(long i = store->length - 2; i >= 0; i--)
+		if(store->paid_taxes_amounts[i] > store->paid_taxes_amounts[highest])
+			highest = i;
+
+	return highest;
+};
+
+// Indexes of all records with the paid taxes amount of the record at index,
+// in order of indexes or in reverse order.
+inline std::vector<long> company_store_scan_ties(CompanyStore * store, long index, bool is_reversed){
+	std::vector<long> indexes;
+
+	if(index < 0)
+		return indexes;
+	for(long i = 0; i < store->length; i++)
+		if(store->paid_taxes_amounts[i] == store->paid_taxes_amounts[index])
+			indexes.push_back(i);
+	if(is_reversed)
+		std::reverse(indexes.begin(), indexes.end());
+
+	return indexes;
+};
+
+// Index of the record with the lowest paid taxes amount, the one with the
+// smallest index among ties, -1 for an empty store.
+inline long company_store_lowest_taxes(CompanyStore * store){
+	if(!store->is_indexed)
+		return company_store_scan_lowest_taxes(store);
+
+	if(store->length == 0)
+		return -1;
+
+	return store->lowest_taxes->records[0];
+};
+
+// Index of the record with the highest paid taxes amount, the one with the
+// largest index among ties, -1 for an empty store.
+inline long company_store_highest_taxes(CompanyStore * store){
+	if(!store->is_indexed)
+		return company_store_scan_highest_taxes(store);
+
+	if(store->length == 0)
+		return -1;
+
+	return store->highest_taxes->records[0];
+};
+
+// Indexes of all records with the lowest paid taxes amount.
+inline std::vector<long> company_store_lowest_taxes_ties(CompanyStore * store){
+	if(!store->is_indexed)
+		return company_store_scan_ties(store, company_store_scan_lowest_taxes(store), false);
+
+	return company_heap_top_ties(store->lowest_taxes, store->paid_taxes_amounts);
+};
+
+// Indexes of all records with the highest paid taxes amount.
+inline std::vector<long> company_store_highest_taxes_ties(CompanyStore * store){
+	if(!store->is_indexed)
+		return company_store_scan_ties(store, company_store_scan_highest_taxes(store), true);
+
+	return company_heap_top_ties(store->highest_taxes, store->paid_taxes_amounts);
+};
+
+// Indexes of k records with the lowest paid taxes amounts, lowest first.
+inline std::vector<long> company_store_lowest_k(CompanyStore * store, long k){
+	company_store_ensure_indexes(store);
+
+	return company_heap_top_k(store->lowest_taxes, store->paid_taxes_amounts, k);
+};
+
+// Indexes of k records with the highest paid taxes amounts, highest first.
+inline std::vector<long> company_store_highest_k(CompanyStore * store, long k){
+	company_store_ensure_indexes(store);
+
+	return company_heap_top_k(store->highest_taxes, store->paid_taxes_amounts, k);
+};
+
+inline long long company_store_taxes_sum(CompanyStore * store){
+	return store->taxes_sum;
+};
+
+inline void free_company_store(CompanyStore * store){
+	if(store->index_builder != NULL){
+		store->index_builder->join();
+		delete store->index_builder;
+	}
+	delete store->lowest_taxes;
+	delete store->highest_taxes;
+	delete store->code_slots;
+	if(!store->is_mapped){
+		free(store->codes);
+		free(store->paid_taxes_amounts);
+		free(store->name_offsets);
+		free(store->names);
+	}
+	free(store);
+};
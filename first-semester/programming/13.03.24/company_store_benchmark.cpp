@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <time.h>
+#include <iostream>
+#include "company_store.h"
+#include "company_io.h"
+
+// Times operation 3 (company which paid lowest taxes amount) on a big store,
+// scalar loop and the kernel selected for the CPU scanning the tax column
+// against the lowest amount kept by the store. Then the store is exported to
+// CSV and binary files, both are imported back and compared with it.
+// Build: g++ -O2 company_store_benchmark.cpp -o company_store_benchmark -pthread
+// Usage: ./company_store_benchmark [companies]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+int main(int argc, char ** argv){
+	long company_amount = argc > 1 ? atol(argv[1]) : 10000000;
+	CompanyStore * company_store = get_company_store();
+	unsigned int seed = 83663;
+	double start, scalar_time, scan_time, store_time;
+	long scalar_lowest, scan_lowest, store_lowest;
+
+	company_store_reserve(company_store, company_amount);
+	for(long i = 0; i < company_amount; i++){
+		seed = seed * 1103515245 + 12345;
+		company_store_add(company_store, (int) i, (int) (seed >> 1), "company");
+	}
+
+	start = get_seconds();
+	scalar_lowest = company_store_lowest_taxes_scalar(company_store->paid_taxes_amounts, company_store->length);
+	scalar_time = get_seconds() - start;
+
+	start = get_seconds();
+	scan_lowest = company_store_scan_lowest_taxes(company_store);
+	scan_time = get_seconds() - start;
+
+	start = get_seconds();
+	store_lowest = company_store_lowest_taxes(company_store);
+	store_time = get_seconds() - start;
+
+	std::cout << "companies: " << company_amount << "\n"
+		<< "scalar: " << scalar_time * 1000 << " ms\n"
+		<< "company_store_scan_lowest_taxes: " << scan_time * 1000 << " ms\n"
+		<< "company_store_lowest_taxes: " << store_time * 1000 << " ms\n"
+		<< (scalar_lowest == scan_lowest && scalar_lowest == store_lowest ? "ok" : "INVALID") << "\n";
+
+	const char * paths[] = {"/tmp/company_store_benchmark.csv", "/tmp/company_store_benchmark.bin"};
+	for(int format = 0; format < 2; format++){
+		CompanyStore * imported_store = get_company_store();
+		double export_time, import_time;
+		long imported;
+		bool is_valid;
+
+		start = get_seconds();
+		is_valid = format == 0 ? company_store_export_csv(company_store, paths[format]) : company_store_export_binary(company_store, paths[format]);
+		export_time = get_seconds() - start;
+
+		start = get_seconds();
+		imported = company_store_import(imported_store, paths[format]);
+		import_time = get_seconds() - start;
+
+		is_valid = is_valid && imported == company_amount && imported_store->taxes_sum == company_store->taxes_sum &&
+			company_store_lowest_taxes(imported_store) == store_lowest;
+		for(long i = 0; i < imported && is_valid; i++)
+			is_valid = imported_store->codes[i] == company_store->codes[i] && imported_store->paid_taxes_amounts[i] == company_store->paid_taxes_amounts[i] &&
+				strcmp(company_store_name(imported_store, i), company_store_name(company_store, i)) == 0;
+
+		std::cout << (format == 0 ? "csv" : "binary") << " export: " << export_time * 1000 << " ms, import: " << import_time * 1000 << " ms "
+			<< (is_valid ? "ok" : "INVALID") << "\n";
+
+		unlink(paths[format]);
+		free_company_store(imported_store);
+	}
+
+	free_company_store(company_store);
+};
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+// Load generator for the company registry server. Every connection sends
+// batches of pipelined commands and waits for all answers of a batch before
+// sending the next one: write_percent of the commands add a company with a
+// code of the connection, min_percent ask for the lowest taxes amount and the
+// rest get a company added earlier by the connection. Prints commands per
+// second and latency percentiles of a batch, from sending it to the last
+// answer.
+//
+// Build: g++ -O2 load_generator.cpp -o load_generator -pthread
+// Usage: ./load_generator [socket path] [connections] [batches per connection] [batch size] [write percent] [min percent]
+
+struct LoadConnection {
+	int id;
+	long batch_amount;
+	long batch_size;
+	long write_percent;
+	long min_percent;
+	const char * socket_path;
+	std::vector<double> latencies;
+	long errors;
+	bool is_failed;
+};
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+int load_connect(const char * path){
+	struct sockaddr_un address = {};
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+	if(fd >= 0 && connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0){
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+};
+
+void load_run_connection(LoadConnection * connection){
+	int fd = load_connect(connection->socket_path);
+	unsigned int seed = 2166136261u ^ connection->id;
+	// codes of a connection do not overlap codes of the other connections and
+	// of recent runs while there are at most 64 connections with 300000 adds
+	int first_code = (int) (((time(NULL) / 10 % 100) * 64 + connection->id % 64) * 300000);
+	long added = 0;
+	std::string batch;
+	char buffer[65536];
+
+	connection->errors = 0;
+	connection->is_failed = fd < 0;
+	for(long i = 0; i < connection->batch_amount && !connection->is_failed; i++){
+		batch.clear();
+		for(long j = 0; j < connection->batch_size; j++){
+			long kind;
+
+			seed = seed * 1103515245 + 12345;
+			kind = (seed >> 8) % 100;
+			if(kind < connection->write_percent || added == 0)
+				batch += "add " + std::to_string(first_code + added++) + " " + std::to_string(seed >> 1) + " company\n";
+			else if(kind < connection->write_percent + connection->min_percent)
+				batch += "min\n";
+			else
+				batch += "get " + std::to_string(first_code + (long) (seed >> 4) % added) + "\n";
+		}
+
+		double start = get_seconds();
+		long written = 0, answers = 0;
+
+		while(written < (long) batch.size()){
+			long result = write(fd, batch.data() + written, batch.size() - written);
+			if(result <= 0){
+				connection->is_failed = true;
+				break;
+			}
+			written += result;
+		}
+		while(!connection->is_failed && answers < connection->batch_size){
+			long result = read(fd, buffer, sizeof(buffer));
+			if(result <= 0){
+				connection->is_failed = true;
+				break;
+			}
+			for(long k = 0; k < result; k++){
+				answers += buffer[k] == '\n';
+				// answers start with "ok", "company" or "error"
+				connection->errors += buffer[k] == 'e' && (k == 0 || buffer[k - 1] == '\n');
+			}
+		}
+		connection->latencies.push_back(get_seconds() - start);
+	}
+
+	if(fd >= 0)
+		close(fd);
+};
+
+int main(int argc, char ** argv){
+	const char * socket_path = argc > 1 ? argv[1] : "/tmp/company_registry.sock";
+	long connection_amount = argc > 2 ? atol(argv[2]) : 8;
+	long batch_amount = argc > 3 ? atol(argv[3]) : 2000;
+	long batch_size = argc > 4 ? atol(argv[4]) : 32;
+	long write_percent = argc > 5 ? atol(argv[5]) : 10;
+	long min_percent = argc > 6 ? atol(argv[6]) : 5;
+	std::vector<LoadConnection> connections(connection_amount);
+	std::vector<std::thread> threads;
+	std::vector<double> latencies;
+	long errors = 0;
+	bool is_failed = false;
+	double start, time;
+
+	start = get_seconds();
+	for(long i = 0; i < connection_amount; i++){
+		connections[i].id = i;
+		connections[i].batch_amount = batch_amount;
+		connections[i].batch_size = batch_size;
+		connections[i].write_percent = write_percent;
+		connections[i].min_percent = min_percent;
+		connections[i].socket_path = socket_path;
+		threads.push_back(std::thread(load_run_connection, &connections[i]));
+	}
+	for(auto & thread : threads)
+		thread.join();
+	time = get_seconds() - start;
+
+	for(auto & connection : connections){
+		latencies.insert(latencies.end(), connection.latencies.begin(), connection.latencies.end());
+		errors += connection.errors;
+		is_failed = is_failed || connection.is_failed;
+	}
+	if(is_failed || latencies.empty()){
+		std::cout << "Error: Connection to " << socket_path << " failed\n";
+		return 1;
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	auto percentile = [&latencies](double p){ return latencies[std::min((long) latencies.size() - 1, (long) (p * latencies.size()))] * 1e6; };
+	std::cout << "connections: " << connection_amount << ", batch size: " << batch_size << ", write: " << write_percent << "%\n"
+		<< "throughput: " << (long) (latencies.size() * batch_size / time) << " commands/s, " << (long) (latencies.size() / time) << " batches/s\n"
+		<< "batch latency p50: " << percentile(0.5) << " us, p99: " << percentile(0.99) << " us, p99.9: " << percentile(0.999)
+		<< " us, max: " << latencies.back() * 1e6 << " us\n"
+		<< "error answers: " << errors << "\n";
+};
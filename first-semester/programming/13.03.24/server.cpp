@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <signal.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <iostream>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include "company_store.h"
+#include "company_io.h"
+#include "company_db.h"
+
+// Company registry server, serves the database of the labs over a UNIX domain
+// socket. Commands are lines, a client may send many of them without waiting
+// for answers and gets one answer line per command in the same order:
+//   add <code> <paid_taxes_amount> <name>  ->  ok | error <reason>
+//   get <code>                            ->  company <code> <paid_taxes_amount> <name> | error not found
+//   min                                   ->  company ... of the lowest taxes amount | error empty
+//   dump                                  ->  company ... line for every record, then end
+//
+// Main thread waits for sockets with epoll and hands a readable connection to
+// a worker of the pool, connections are armed with EPOLLONESHOT so one worker
+// has a connection at a time. The worker reads everything the client has sent
+// and runs all complete lines as one batch: a batch with an add takes the
+// store exclusively, other batches share it, so a batch sees the store either
+// before or after every other batch.
+//
+// Build: g++ -O2 -std=c++17 server.cpp -o server -pthread
+// Usage: ./server [socket path] [database path] [workers]
+
+#define COMPANY_SERVER_READ_SIZE 65536
+#define COMPANY_SERVER_MAX_INPUT (1 << 20)
+
+struct CompanyConnection {
+	int fd;
+	std::string input;
+	std::string output;
+};
+
+struct CompanyServer {
+	int epoll_fd;
+	int listen_fd;
+	int signal_fd;
+	CompanyDatabase * db;
+	std::shared_mutex store_mutex;
+	std::mutex queue_mutex;
+	std::condition_variable queue_condition;
+	std::deque<CompanyConnection *> queue;
+	bool is_stopped;
+};
+
+void company_server_print_company(CompanyStore * store, long index, std::string & output){
+	char line[64];
+
+	snprintf(line, sizeof(line), "company %d %d ", store->codes[index], store->paid_taxes_amounts[index]);
+	output += line;
+	output += company_store_name(store, index);
+	output += '\n';
+};
+
+// Reads a number from line, false when there are no digits or it does not
+// fit in int. End is moved past the number.
+bool company_server_parse_int(char * line, char ** end, int * value){
+	long number;
+
+	errno = 0;
+	number = strtol(line, end, 10);
+	if(*end == line || errno == ERANGE || number < INT_MIN || number > INT_MAX)
+		return false;
+	*value = (int) number;
+
+	return true;
+};
+
+// Runs one command line, the store is locked by the caller.
+void company_server_run_command(CompanyServer * server, char * line, std::string & output){
+	CompanyStore * store = server->db->store;
+	char * end;
+	int code, paid_taxes_amount;
+
+	if(strncmp(line, "add ", 4) == 0){
+		if(!company_server_parse_int(line + 4, &end, &code) || *end != ' ' ||
+			!company_server_parse_int(end, &end, &paid_taxes_amount) || *end != ' ' || end[1] == '\0')
+			output += "error malformed command\n";
+		else if(company_db_add(server->db, code, paid_taxes_amount, end + 1) < 0)
+			output += "error code exists or database is full\n";
+		else
+			output += "ok\n";
+	} else if(strncmp(line, "get ", 4) == 0){
+		long index;
+
+		if(!company_server_parse_int(line + 4, &end, &code) || *end != '\0'){
+			output += "error malformed command\n";
+			return;
+		}
+		index = company_store_find(store, code);
+		if(index >= 0)
+			company_server_print_company(store, index, output);
+		else
+			output += "error not found\n";
+	} else if(strcmp(line, "min") == 0){
+		long index = company_store_lowest_taxes(store);
+
+		if(index >= 0)
+			company_server_print_company(store, index, output);
+		else
+			output += "error empty\n";
+	} else if(strcmp(line, "dump") == 0){
+		for(long i = 0; i < store->length; i++)
+			company_server_print_company(store, i, output);
+		output += "end\n";
+	} else {
+		output += "error unknown command\n";
+	}
+};
+
+// Runs complete lines of the input as one batch and drops them from it.
+void company_server_run_batch(CompanyServer * server, CompanyConnection * connection){
+	std::vector<char *> lines;
+	bool is_writing = false;
+	long begin = 0, end;
+
+	while((end = connection->input.find('\n', begin)) != (long) std::string::npos){
+		char * line = &connection->input[begin];
+
+		connection->input[end] = '\0';
+		if(end > begin && connection->input[end - 1] == '\r')
+			connection->input[end - 1] = '\0';
+		is_writing = is_writing || strncmp(line, "add ", 4) == 0;
+		lines.push_back(line);
+		begin = end + 1;
+	}
+	if(lines.empty())
+		return;
+
+	if(is_writing){
+		std::unique_lock<std::shared_mutex> lock(server->store_mutex);
+		for(char * line : lines)
+			company_server_run_command(server, line, connection->output);
+	} else {
+		std::shared_lock<std::shared_mutex> lock(server->store_mutex);
+		for(char * line : lines)
+			company_server_run_command(server, line, connection->output);
+	}
+
+	connection->input.erase(0, begin);
+};
+
+// Writes as much of the output as the socket takes, false on error.
+bool company_server_flush(CompanyConnection * connection){
+	long written = 0;
+
+	while(written < (long) connection->output.size()){
+		long result = write(connection->fd, connection->output.data() + written, connection->output.size() - written);
+
+		if(result < 0 && errno == EINTR)
+			continue;
+		if(result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if(result <= 0)
+			return false;
+		written += result;
+	}
+	connection->output.erase(0, written);
+
+	return true;
+};
+
+// Reads, runs and answers what the client has sent, then arms the connection
+// again. Nothing is read while answers are waiting for the client, so a
+// client which does not read can not make the server buffer without limit.
+void company_server_serve(CompanyServer * server, CompanyConnection * connection){
+	char buffer[COMPANY_SERVER_READ_SIZE];
+	bool is_open = company_server_flush(connection);
+
+	while(is_open && connection->output.empty()){
+		long result = read(connection->fd, buffer, sizeof(buffer));
+
+		if(result < 0 && errno == EINTR)
+			continue;
+		if(result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if(result <= 0){
+			is_open = false;
+			break;
+		}
+
+		connection->input.append(buffer, result);
+		company_server_run_batch(server, connection);
+		is_open = connection->input.size() <= COMPANY_SERVER_MAX_INPUT && company_server_flush(connection);
+	}
+
+	if(!is_open){
+		epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+		close(connection->fd);
+		delete connection;
+		return;
+	}
+
+	struct epoll_event event;
+	event.events = EPOLLONESHOT | (connection->output.empty() ? EPOLLIN : EPOLLOUT);
+	event.data.ptr = connection;
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+};
+
+void company_server_run_worker(CompanyServer * server){
+	while(true){
+		CompanyConnection * connection;
+		{
+			std::unique_lock<std::mutex> lock(server->queue_mutex);
+			server->queue_condition.wait(lock, [server]{ return server->is_stopped || !server->queue.empty(); });
+			if(server->queue.empty())
+				return;
+			connection = server->queue.front();
+			server->queue.pop_front();
+		}
+		company_server_serve(server, connection);
+	}
+};
+
+void company_server_accept(CompanyServer * server){
+	int fd;
+
+	while((fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0){
+		CompanyConnection * connection = new CompanyConnection();
+		struct epoll_event event;
+
+		connection->fd = fd;
+		event.events = EPOLLIN | EPOLLONESHOT;
+		event.data.ptr = connection;
+		epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+	}
+};
+
+int company_server_listen(const char * path){
+	struct sockaddr_un address = {};
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if(fd < 0 || strlen(path) >= sizeof(address.sun_path)){
+		if(fd >= 0)
+			close(fd);
+		return -1;
+	}
+
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path);
+	unlink(path);
+	if(bind(fd, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0){
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+};
+
+int main(int argc, char ** argv){
+	const char * socket_path = argc > 1 ? argv[1] : "/tmp/company_registry.sock";
+	const char * database_path = argc > 2 ? argv[2] : "companies.db";
+	long worker_amount = argc > 3 ? atol(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+	CompanyServer * server = new CompanyServer();
+	std::vector<std::thread> workers;
+	struct epoll_event event, events[64];
+	sigset_t signals;
+
+	server->db = open_company_database(database_path, 1 << 16, 1 << 20, 16 << 20);
+	if(server->db == NULL){
+		std::cout << "Error: Can not open company database\n";
+		return 1;
+	}
+	// waits for the indexes built since the open, lookups of the workers only
+	// read the store after this
+	company_store_ensure_indexes(server->db->store);
+
+	server->listen_fd = company_server_listen(socket_path);
+	if(server->listen_fd < 0){
+		std::cout << "Error: Can not listen on " << socket_path << "\n";
+		close_company_database(server->db, true);
+		return 1;
+	}
+
+	// SIGINT and SIGTERM stop the loop, the database is closed with a checkpoint
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	sigaddset(&signals, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &signals, NULL);
+	sigdelset(&signals, SIGPIPE);
+	server->signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+
+	server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	event.events = EPOLLIN;
+	event.data.ptr = &server->listen_fd;
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &event);
+	event.data.ptr = &server->signal_fd;
+	epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->signal_fd, &event);
+
+	server->is_stopped = false;
+	for(long i = 0; i < worker_amount; i++)
+		workers.push_back(std::thread(company_server_run_worker, server));
+
+	std::cout << "Listening on " << socket_path << " with " << worker_amount << " workers, companies: " << server->db->store->length << "\n";
+
+	while(!server->is_stopped){
+		int event_amount = epoll_wait(server->epoll_fd, events, 64, -1);
+		bool is_queued = false;
+
+		for(int i = 0; i < event_amount; i++){
+			if(events[i].data.ptr == &server->listen_fd){
+				company_server_accept(server);
+			} else if(events[i].data.ptr == &server->signal_fd){
+				std::lock_guard<std::mutex> lock(server->queue_mutex);
+				server->is_stopped = true;
+			} else {
+				std::lock_guard<std::mutex> lock(server->queue_mutex);
+				server->queue.push_back((CompanyConnection *) events[i].data.ptr);
+				is_queued = true;
+			}
+		}
+		if(is_queued || server->is_stopped)
+			server->queue_condition.notify_all();
+	}
+
+	for(auto & worker : workers)
+		worker.join();
+	// connections still in the queue are closed with the process
+	close(server->listen_fd);
+	unlink(socket_path);
+	std::cout << "Stopped, companies: " << server->db->store->length << "\n";
+	close_company_database(server->db, true);
+};
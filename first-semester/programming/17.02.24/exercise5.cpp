@@ -1,37 +1,142 @@
 #include <stdio.h>
-#include <iostream>
-#include <malloc.h>
+#include <stdint.h>
 #include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
-int main(void){
-	int i = 0;
+// Counts every byte value of the input: files given as arguments or stdin
+// until its end, and prints the count of every byte that occurs except the
+// line ending. Files and stdin redirected from a file are mapped and split
+// into chunks counted by all threads, other stdin is read in blocks.
+// Counters are 64-bit, a chunk is counted into 8 tables of 32-bit counters
+// used in turn, so increments of the same byte value repeating in the input
+// do not wait for each other.
+// Build: g++ -O2 exercise5.cpp -o exercise5 -pthread
+// Usage: ./exercise5 [files] or ./exercise5 < file
+
+#define HISTOGRAM_TABLES 8
+#define HISTOGRAM_CHUNK_SIZE (16 << 20)
+
+void count_bytes(const unsigned char * data, long length, uint64_t * counts){
+	uint32_t tables[HISTOGRAM_TABLES][256];
+	long i = 0;
+
+	memset(tables, 0, sizeof(tables));
+
+	// two words per step, so loads run ahead of the increments
+	for(; i + 16 <= length; i += 16){
+		uint64_t words[2];
+		memcpy(words, data + i, 16);
+		for(int k = 0; k < 2; k++){
+			tables[0][words[k] & 0xff]++;
+			tables[1][(words[k] >> 8) & 0xff]++;
+			tables[2][(words[k] >> 16) & 0xff]++;
+			tables[3][(words[k] >> 24) & 0xff]++;
+			tables[4][(words[k] >> 32) & 0xff]++;
+			tables[5][(words[k] >> 40) & 0xff]++;
+			tables[6][(words[k] >> 48) & 0xff]++;
+			tables[7][words[k] >> 56]++;
+		}
+	}
+	for(; i < length; i++)
+		tables[0][data[i]]++;
+
+	for(int j = 0; j < 256; j++)
+		for(int k = 0; k < HISTOGRAM_TABLES; k++)
+			counts[j] += tables[k][j];
+};
+
+// Chunks of HISTOGRAM_CHUNK_SIZE bytes keep 32-bit counters from overflowing,
+// threads take the next chunk when they are done with one.
+void count_bytes_parallel(const unsigned char * data, long length, uint64_t * counts){
+	long chunk_amount = (length + HISTOGRAM_CHUNK_SIZE - 1) / HISTOGRAM_CHUNK_SIZE;
+	long thread_amount = std::min((long) std::max(1u, std::thread::hardware_concurrency()), chunk_amount);
+	std::vector<std::vector<uint64_t>> thread_counts(thread_amount, std::vector<uint64_t>(256, 0));
+	std::vector<std::thread> threads;
+	std::atomic<long> next_chunk(0);
+
+	auto count_chunks = [&](long thread){
+		long chunk;
+		while((chunk = next_chunk.fetch_add(1)) < chunk_amount)
+			count_bytes(data + chunk * HISTOGRAM_CHUNK_SIZE, std::min(length - chunk * HISTOGRAM_CHUNK_SIZE, (long) HISTOGRAM_CHUNK_SIZE),
+				thread_counts[thread].data());
+	};
+
+	for(long i = 1; i < thread_amount; i++)
+		threads.push_back(std::thread(count_chunks, i));
+	if(thread_amount > 0)
+		count_chunks(0);
+	for(auto & thread : threads)
+		thread.join();
 
-	// create character map
-	char *map = (char *) malloc(sizeof(char) * 128);
+	for(auto & thread_count : thread_counts)
+		for(int j = 0; j < 256; j++)
+			counts[j] += thread_count[j];
+};
 
-	// populate map with zeros
-	while((*(map + i++) = (char) 0));
+// Returns false when the input can not be read.
+bool count_file(int fd, uint64_t * counts){
+	struct stat file_stat;
 
-	// create buffer
-	i = 0;
-	char *a = (char *) malloc(sizeof(char) * 100);
+	if(fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)){
+		if(file_stat.st_size == 0)
+			return true;
 
-	// get string	
-	while((*(a + i++) = getchar()) != 10);
-	a[i] = '\0';
+		void * data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data != MAP_FAILED){
+			madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+			count_bytes_parallel((const unsigned char *) data, file_stat.st_size, counts);
+			munmap(data, file_stat.st_size);
+			return true;
+		}
+	}
+
+	std::vector<unsigned char> buffer(HISTOGRAM_CHUNK_SIZE);
+	long length;
+
+	while((length = read(fd, buffer.data(), buffer.size())) != 0){
+		if(length < 0)
+			return false;
+		count_bytes(buffer.data(), length, counts);
+	}
+
+	return true;
+};
 
-	// count amount of chars
-	i = 0;
-	while(i < strlen(a)) map[*(a + i++)]++;
+int main(int argc, char ** argv){
+	uint64_t counts[256] = {0};
+	int i = 0;
+
+	if(argc == 1 && !count_file(0, counts)){
+		fprintf(stderr, "Error: Can not read input\n");
+		return 1;
+	}
+	for(i = 1; i < argc; i++){
+		int fd = open(argv[i], O_RDONLY);
+
+		if(fd < 0 || !count_file(fd, counts)){
+			fprintf(stderr, "Error: Can not read %s\n", argv[i]);
+			return 1;
+		}
+		close(fd);
+	}
 
-	// print characters 
-	i = 0;
-	while( i < 128){
-		if(map[i] > 0 && i != 10)
-			printf("%c %d\n", i, map[i]);
-		i++;
+	// print characters, bytes which are not printable as their code
+	for(i = 0; i < 256; i++){
+		if(counts[i] > 0 && i != 10){
+			if(isprint(i))
+				printf("%c %llu\n", i, (unsigned long long) counts[i]);
+			else
+				printf("\\x%02x %llu\n", i, (unsigned long long) counts[i]);
+		}
 	}
-	
 
 	return 0;
 }
@@ -2,22 +2,71 @@
 #include <iostream>
 #include <stdlib.h>
 #include <time.h>
+#include <vector>
+#include "matrix.h"
+#include "random.h"
+#include "matrix_stream.h"
+
+// Matrices with more values are not printed.
+#define LAB5_PRINT_SIZE 10000
 
 // 83663 % 30 = 23
 
-int main(){
+// With a matrix file as argument rows are read from it block by block and
+// only the numbers are asked, the file may be bigger than memory.
+int lab5_stream(const char * path){
+	MatrixStream * stream = open_matrix_stream(path);
+	long threshold_amount;
+	std::vector<long> number_of_rows;
+
+	if(stream == NULL){
+		std::cout << "Error: Can not read matrix file" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Matrix " << stream->rows << " x " << stream->columns << std::endl;
+	std::cout << "Type amount of numbers: ";
+	std::cin >> threshold_amount;
+
+	std::vector<long long> x(std::max(threshold_amount, 0L));
+	std::cout << "Type numbers: ";
+	for(auto & number : x)
+		std::cin >> number;
+
+	if(!matrix_stream_count_rows_below(stream, x, number_of_rows)){
+		std::cout << "Error: Matrix file is malformed" << std::endl;
+		close_matrix_stream(stream);
+		return 1;
+	}
+
+	for(long i = 0; i < (long) x.size(); i++){
+		std::cout << "Number of rows where element average is less than " << x[i] << ": ";
+		std::cout << number_of_rows[i] << std::endl;
+	}
+
+	close_matrix_stream(stream);
+	return 0;
+}
+
+int main(int argc, char ** argv){
 	int end = false;
 	int m, n, fill_mode, from, to;
-	int **arr;
-	int number_of_rows;
+	Matrix * matrix = get_matrix();
+	long threshold_amount;
+	RandomGenerator generator;
 
-	srand(time(NULL));
+	if(argc > 1){
+		free_matrix(matrix);
+		return lab5_stream(argv[1]);
+	}
+
+	random_seed(&generator, time(NULL));
 
 	while(end == false){
-		number_of_rows = 0;
-	
 		std::cout << "Enter amount of rows" << std::endl;
 		std::cin >> m;
+		if(!std::cin)
+			break;
 
 		std::cout << "Enter amount of columns" << std::endl;
 		std::cin >> n;
@@ -27,64 +76,60 @@ int main(){
 		std::cout << "Enter filling mode (0 - manual, 1 - automatic with random values)" << std::endl;
 		std::cin >> fill_mode;
 
-		arr = (int **) malloc(m * sizeof(int *));
+		if(!matrix_resize(matrix, m, n)){
+			std::cout << "Error: Can not allocate " << m << " x " << n << " matrix" << std::endl;
+			continue;
+		}
 
 		if(fill_mode == 1){
 			std::cout << "Random values from: ";
 			std::cin >> from;
 			std::cout << "Random values to: ";
 			std::cin >> to;
-		}
+			if(from > to)
+				std::swap(from, to);
+
+			// Automatic, padded rows are filled whole and padding is cleared after.
+			random_fill_uniform_parallel(&generator, matrix->values, matrix->rows * matrix->stride, from, to);
+			matrix_clear_padding(matrix);
+		} else {
+			for(int i = 0; i < m; i++){
+				int * row = matrix_row(matrix, i);
 
-		for(int i = 0; i < m; i++){
-			*(arr  + i) = (int *) malloc(n * sizeof(int));
-			
-			if(fill_mode == 0)
 				std::cout << "Enter " << i << " row values" << std::endl;
 
-			for(int j = 0; j < n; j++){
-				if(fill_mode == 0){
-					// Manual.
-					std::cin >> *(*(arr + i) + j);
-
-				} else {
-					// Automatic.
-					int k = 0;
-					while(k == 0){
-						k = (rand() % to) + from;
-						if(k >= from && k <= to)
-							*(*(arr + i) + j) = k;
-						else 
-							k = 0;
-
-					}
-				}
+				// Manual.
+				for(int j = 0; j < n; j++)
+					std::cin >> row[j];
 			}
 		}
 
 		// Print 2 dimensional array.
-		for(int i = 0; i < m; i++){
-			for(int j = 0; j < n; j++){
-				std::cout << *(*(arr + i) + j) << " ";
+		if((long) m * n <= LAB5_PRINT_SIZE){
+			for(int i = 0; i < m; i++){
+				for(int j = 0; j < n; j++){
+					std::cout << matrix_row(matrix, i)[j] << " ";
+				}
+				std::cout << std::endl;
 			}
-			std::cout << std::endl;
 		}
 
-		int x = 0;
-		std::cout << "Type a number: ";
-		std::cin >> x;
-
-		for(int i = 0; i < m; i++){
-			int a = 0;
-			for(int j = 0; j < n; j++)
-				a += *(*(arr + i) + j);
-			
-			if((a / n) < x)
-				number_of_rows++;
-		}
+		std::cout << "Type amount of numbers: ";
+		std::cin >> threshold_amount;
+
+		std::vector<long long> x(std::max(threshold_amount, 0L));
+		std::cout << "Type numbers: ";
+		for(auto & number : x)
+			std::cin >> number;
 
-		std::cout << "Number of rows where element average is less than entered value: ";
-		std::cout << number_of_rows << std::endl;
+		std::vector<long> number_of_rows = matrix_count_rows_below(matrix, x);
+
+		for(long i = 0; i < (long) x.size(); i++){
+			std::cout << "Number of rows where element average is less than " << x[i] << ": ";
+			std::cout << number_of_rows[i] << std::endl;
+		}
 	}
+
+	free_matrix(matrix);
 }
 
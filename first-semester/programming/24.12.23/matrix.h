@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define MATRIX_AVX2
+#endif
+
+// Matrix of ints kept in one row-major buffer. Rows are padded to a multiple
+// of 8 values so every row starts 32-byte aligned for AVX2 loads. The buffer
+// is reused by matrix_resize and only grows, so a new matrix of the same or
+// smaller size does not allocate.
+
+#define MATRIX_PARALLEL_SIZE (1 << 20)
+
+struct Matrix {
+	int * values;
+	long rows;
+	long columns;
+	long stride;
+	long capacity;
+};
+
+inline Matrix * get_matrix(){
+	Matrix * matrix = (Matrix *) malloc(sizeof(Matrix));
+
+	matrix->values = NULL;
+	matrix->rows = 0;
+	matrix->columns = 0;
+	matrix->stride = 0;
+	matrix->capacity = 0;
+
+	return matrix;
+};
+
+// Padding is summed by the AVX2 kernel, it has to be zero. Fills which write
+// whole padded rows call this after.
+inline void matrix_clear_padding(Matrix * matrix){
+	if(matrix->stride != matrix->columns)
+		for(long i = 0; i < matrix->rows; i++)
+			memset(matrix->values + i * matrix->stride + matrix->columns, 0, (matrix->stride - matrix->columns) * sizeof(int));
+};
+
+// Values of the matrix are not kept. Returns false when the size is negative,
+// overflows or can not be allocated, then the matrix is not changed.
+inline bool matrix_resize(Matrix * matrix, long rows, long columns){
+	long stride, size, bytes;
+
+	if(rows < 0 || columns < 0 || columns > __LONG_MAX__ - 7)
+		return false;
+	stride = (columns + 7) / 8 * 8;
+	if(__builtin_mul_overflow(rows, stride, &size) || __builtin_mul_overflow(std::max(size, 8L), (long) sizeof(int), &bytes))
+		return false;
+
+	if(size > matrix->capacity){
+		int * values = (int *) aligned_alloc(32, bytes);
+		if(values == NULL)
+			return false;
+		free(matrix->values);
+		matrix->values = values;
+		matrix->capacity = size;
+	}
+
+	matrix->rows = rows;
+	matrix->columns = columns;
+	matrix->stride = stride;
+	matrix_clear_padding(matrix);
+
+	return true;
+};
+
+inline int * matrix_row(Matrix * matrix, long row){
+	return matrix->values + row * matrix->stride;
+};
+
+inline void free_matrix(Matrix * matrix){
+	free(matrix->values);
+	free(matrix);
+};
+
+inline long long matrix_row_sum_scalar(const int * row, long length){
+	long long sum = 0;
+
+	for(long i = 0; i < length; i++)
+		sum += row[i];
+
+	return sum;
+};
+
+#ifdef MATRIX_AVX2
+
+// Widens 8 values at a time to 64 bits, so sums of long rows do not
+// overflow. The row has to be padded with zeros to a multiple of 8.
+__attribute__((target("avx2")))
+inline long long matrix_row_sum_avx2(const int * row, long length){
+	__m256i sum0 = _mm256_setzero_si256(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+	long i = 0;
+
+	for(; i + 16 <= length; i += 16){
+		__m256i values0 = _mm256_load_si256((const __m256i *)(row + i));
+		__m256i values1 = _mm256_load_si256((const __m256i *)(row + i + 8));
+		sum0 = _mm256_add_epi64(sum0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values0)));
+		sum1 = _mm256_add_epi64(sum1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values0, 1)));
+		sum2 = _mm256_add_epi64(sum2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values1)));
+		sum3 = _mm256_add_epi64(sum3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values1, 1)));
+	}
+	for(; i < length; i += 8){
+		__m256i values = _mm256_load_si256((const __m256i *)(row + i));
+		sum0 = _mm256_add_epi64(sum0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+		sum1 = _mm256_add_epi64(sum1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+	}
+	sum0 = _mm256_add_epi64(_mm256_add_epi64(sum0, sum1), _mm256_add_epi64(sum2, sum3));
+
+	__m128i sum = _mm_add_epi64(_mm256_castsi256_si128(sum0), _mm256_extracti128_si256(sum0, 1));
+	return _mm_cvtsi128_si64(sum) + _mm_extract_epi64(sum, 1);
+};
+
+#endif
+
+// Sum of a row of the matrix, AVX2 kernel is used when the CPU supports it.
+inline long long matrix_row_sum(Matrix * matrix, long row){
+#ifdef MATRIX_AVX2
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if(has_avx2)
+		return matrix_row_sum_avx2(matrix_row(matrix, row), matrix->stride);
+#endif
+
+	return matrix_row_sum_scalar(matrix_row(matrix, row), matrix->columns);
+};
+
+// Adds rows from first_row to last_row to below, below[i] counts rows whose
+// average is less than sorted_thresholds[i] and not less than the previous one.
+inline void matrix_count_rows_below_part(Matrix * matrix, long first_row, long last_row,
+	const std::vector<long long> & sorted_thresholds, std::vector<long> & below){
+	for(long i = first_row; i < last_row; i++){
+		long long average = matrix_row_sum(matrix, i) / matrix->columns;
+		long first = std::upper_bound(sorted_thresholds.begin(), sorted_thresholds.end(), average) - sorted_thresholds.begin();
+
+		if(first < (long) below.size())
+			below[first]++;
+	}
+};
+
+// For every threshold x counts rows where (sum of row / columns) < x, with the
+// integer division of the lab. All thresholds are answered in one pass over
+// the matrix, each row is summed once. Rows are split between threads when
+// the matrix is big.
+inline std::vector<long> matrix_count_rows_below(Matrix * matrix, const std::vector<long long> & thresholds){
+	std::vector<long long> sorted_thresholds(thresholds);
+	std::vector<long> counts(thresholds.size(), 0);
+	long part_amount = 1;
+
+	if(matrix->columns == 0 || thresholds.empty())
+		return counts;
+
+	std::sort(sorted_thresholds.begin(), sorted_thresholds.end());
+	if(matrix->rows * matrix->columns >= MATRIX_PARALLEL_SIZE)
+		part_amount = std::min((long) std::max(1u, std::thread::hardware_concurrency()), matrix->rows);
+
+	std::vector<std::vector<long>> below(part_amount, std::vector<long>(sorted_thresholds.size(), 0));
+	std::vector<std::thread> threads;
+	for(long i = 1; i < part_amount; i++)
+		threads.push_back(std::thread(matrix_count_rows_below_part, matrix, matrix->rows * i / part_amount,
+			matrix->rows * (i + 1) / part_amount, std::cref(sorted_thresholds), std::ref(below[i])));
+	matrix_count_rows_below_part(matrix, 0, matrix->rows / part_amount, sorted_thresholds, below[0]);
+	for(auto & thread : threads)
+		thread.join();
+
+	// a row below a threshold is below every greater one
+	std::vector<long> sorted_counts(sorted_thresholds.size(), 0);
+	for(long i = 0; i < (long) sorted_counts.size(); i++){
+		sorted_counts[i] = i > 0 ? sorted_counts[i - 1] : 0;
+		for(long j = 0; j < part_amount; j++)
+			sorted_counts[i] += below[j][i];
+	}
+	for(long i = 0; i < (long) thresholds.size(); i++){
+		long last = std::upper_bound(sorted_thresholds.begin(), sorted_thresholds.end(), thresholds[i]) - sorted_thresholds.begin() - 1;
+		counts[i] = sorted_counts[last];
+	}
+
+	return counts;
+};
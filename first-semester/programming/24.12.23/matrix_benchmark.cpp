@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include "matrix.h"
+
+// Times "rows with average below x" on a big matrix: scalar loop over the rows
+// like the lab had, then matrix_count_rows_below with one and with many
+// thresholds. Prints bandwidth of the matrix read, answers have to match.
+// Build: g++ -O2 matrix_benchmark.cpp -o matrix_benchmark -pthread
+// Usage: ./matrix_benchmark [rows] [columns]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+int main(int argc, char ** argv){
+	long rows = argc > 1 ? atol(argv[1]) : 8192;
+	long columns = argc > 2 ? atol(argv[2]) : 8192;
+	Matrix * matrix = get_matrix();
+	unsigned int seed = 83663;
+	std::vector<long long> thresholds;
+	std::vector<long> scalar_counts, counts, many_counts;
+	double start, scalar_time, time, many_time;
+	double size = (double) rows * columns * sizeof(int) / 1e9;
+	bool is_valid = true;
+
+	if(!matrix_resize(matrix, rows, columns)){
+		std::cout << "Error: Can not allocate " << rows << " x " << columns << " matrix\n";
+		return 1;
+	}
+	for(long i = 0; i < rows; i++){
+		int * row = matrix_row(matrix, i);
+		for(long j = 0; j < columns; j++){
+			seed = seed * 1103515245 + 12345;
+			row[j] = (int) (seed >> 16) % 1000 - 100 + i % 200;
+		}
+	}
+	for(long i = 0; i < 16; i++)
+		thresholds.push_back(400 + i * 10);
+
+	start = get_seconds();
+	for(long long x : thresholds){
+		long number_of_rows = 0;
+		for(long i = 0; i < rows; i++)
+			if(matrix_row_sum_scalar(matrix_row(matrix, i), columns) / columns < x)
+				number_of_rows++;
+		scalar_counts.push_back(number_of_rows);
+	}
+	scalar_time = (get_seconds() - start) / thresholds.size();
+
+	start = get_seconds();
+	for(long long x : thresholds)
+		counts.push_back(matrix_count_rows_below(matrix, std::vector<long long>(1, x))[0]);
+	time = (get_seconds() - start) / thresholds.size();
+
+	start = get_seconds();
+	many_counts = matrix_count_rows_below(matrix, thresholds);
+	many_time = get_seconds() - start;
+
+	for(long i = 0; i < (long) thresholds.size(); i++)
+		is_valid = is_valid && scalar_counts[i] == counts[i] && scalar_counts[i] == many_counts[i];
+
+	std::cout << "matrix: " << rows << " x " << columns << ", " << size << " GB\n"
+		<< "scalar, one threshold: " << scalar_time * 1000 << " ms, " << size / scalar_time << " GB/s\n"
+		<< "matrix_count_rows_below, one threshold: " << time * 1000 << " ms, " << size / time << " GB/s\n"
+		<< "matrix_count_rows_below, " << thresholds.size() << " thresholds: " << many_time * 1000 << " ms, " << size / many_time << " GB/s\n"
+		<< (is_valid ? "ok" : "INVALID") << "\n";
+
+	free_matrix(matrix);
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <charconv>
+#include <mutex>
+#include <condition_variable>
+#include "matrix.h"
+
+// Row blocks of a matrix file which does not have to fit in memory. Binary
+// files start with MatrixFileHeader followed by rows * columns ints row by
+// row, text files start with amount of rows and columns followed by the values
+// separated by any whitespace. matrix_stream_count_rows_below reads the next
+// block in a thread while the current one is counted, so only two blocks of
+// about MATRIX_STREAM_BLOCK_SIZE bytes are in memory. A row which does not fit
+// into a block is read in parts of its columns.
+
+#define MATRIX_STREAM_BLOCK_SIZE (32 << 20)
+#define MATRIX_STREAM_TEXT_SIZE (1 << 20)
+
+struct MatrixFileHeader {
+	char magic[8];
+	long rows;
+	long columns;
+};
+
+struct MatrixStream {
+	int fd;
+	bool is_binary;
+	long rows;
+	long columns;
+	long rows_read;
+	// columns of the current row already read when rows are read in parts
+	long columns_read;
+	long offset;
+	std::vector<int> raw;
+	char * text;
+	long text_begin;
+	long text_end;
+	bool is_text_end;
+};
+
+// Next integer of a text stream, false at the end of the file or for a
+// malformed value. A value is parsed only when the whitespace after it is in
+// the buffer, the rest of the buffer is moved to its start before a read.
+inline bool matrix_stream_next_value(MatrixStream * stream, long long * value){
+	while(true){
+		char * p = stream->text + stream->text_begin;
+		char * end = stream->text + stream->text_end;
+
+		while(p < end && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r'))
+			p++;
+		stream->text_begin = p - stream->text;
+
+		char * token_end = p;
+		while(token_end < end && !(*token_end == ' ' || *token_end == '\n' || *token_end == '\t' || *token_end == '\r'))
+			token_end++;
+
+		if(p < end && (token_end < end || stream->is_text_end)){
+			auto result = std::from_chars(p, token_end, *value);
+			stream->text_begin = token_end - stream->text;
+			return result.ec == std::errc() && result.ptr == token_end;
+		}
+		if(stream->is_text_end)
+			return false;
+
+		long length = end - p;
+		if(length == MATRIX_STREAM_TEXT_SIZE)
+			return false;
+		memmove(stream->text, p, length);
+		stream->text_begin = 0;
+		stream->text_end = length;
+
+		long result = read(stream->fd, stream->text + length, MATRIX_STREAM_TEXT_SIZE - length);
+		if(result < 0)
+			return false;
+		stream->text_end += result;
+		stream->is_text_end = result == 0;
+	}
+};
+
+inline void close_matrix_stream(MatrixStream * stream){
+	close(stream->fd);
+	free(stream->text);
+	delete stream;
+};
+
+// Returns NULL when the file can not be read or its size is malformed. A
+// header is malformed when the values it announces can not fit into the file,
+// 4 bytes each in a binary file and at least 1 character each in a text one.
+inline MatrixStream * open_matrix_stream(const char * path){
+	int fd = open(path, O_RDONLY);
+	MatrixStream * stream;
+	MatrixFileHeader header;
+	struct stat file_stat;
+	long long rows = -1, columns = -1;
+	long values, size;
+
+	if(fd < 0)
+		return NULL;
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	stream = new MatrixStream();
+	stream->fd = fd;
+	stream->rows_read = 0;
+	stream->columns_read = 0;
+	stream->text = (char *) malloc(MATRIX_STREAM_TEXT_SIZE);
+	stream->text_begin = 0;
+	stream->text_end = 0;
+	stream->is_text_end = false;
+
+	stream->is_binary = pread(fd, &header, sizeof(header), 0) == sizeof(header) && memcmp(header.magic, "MATRIX01", 8) == 0;
+	if(stream->is_binary){
+		rows = header.rows;
+		columns = header.columns;
+		stream->offset = sizeof(header);
+	} else if(!matrix_stream_next_value(stream, &rows) || !matrix_stream_next_value(stream, &columns)){
+		rows = -1;
+	}
+
+	// size of a pipe is not known, reads of it fail at its end instead
+	if(rows < 0 || columns < 0 || __builtin_mul_overflow(rows, columns, &values) ||
+		(fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) &&
+		(stream->is_binary ? __builtin_mul_overflow(values, (long) sizeof(int), &size) || size > file_stat.st_size - (long) sizeof(header) : values > file_stat.st_size))){
+		close_matrix_stream(stream);
+		return NULL;
+	}
+	stream->rows = rows;
+	stream->columns = columns;
+
+	return stream;
+};
+
+// Reads the next rows to block, resizing it, returns amount of rows, 0 at the
+// end and -1 when the file is shorter than its header says, malformed or the
+// block does not fit into memory. Rows wider than block_columns are read one
+// part of at most block_columns columns at a time, the block is then one row
+// and 1 is returned for every part.
+inline long matrix_stream_read_block(MatrixStream * stream, Matrix * block, long block_rows, long block_columns){
+	long rows = std::min(block_rows, stream->rows - stream->rows_read);
+	long columns = stream->columns;
+
+	if(columns > block_columns){
+		rows = std::min(rows, 1L);
+		columns = std::min(block_columns, stream->columns - stream->columns_read);
+	}
+	if(!matrix_resize(block, rows, columns))
+		return -1;
+	if(rows == 0)
+		return 0;
+
+	if(stream->is_binary){
+		long size = rows * columns * sizeof(int), done = 0;
+		// rows go straight to the block when they have no padding
+		char * data = (char *) block->values;
+
+		if(block->stride != block->columns){
+			stream->raw.resize(rows * columns);
+			data = (char *) stream->raw.data();
+		}
+		while(done < size){
+			long result = pread(stream->fd, data + done, size - done, stream->offset + done);
+			if(result <= 0)
+				return -1;
+			done += result;
+		}
+		// read pages are not needed again
+		posix_fadvise(stream->fd, stream->offset, size, POSIX_FADV_DONTNEED);
+		stream->offset += size;
+
+		if(block->stride != block->columns)
+			for(long i = 0; i < rows; i++)
+				memcpy(matrix_row(block, i), stream->raw.data() + i * columns, columns * sizeof(int));
+	} else {
+		for(long i = 0; i < rows; i++){
+			int * row = matrix_row(block, i);
+			for(long j = 0; j < columns; j++){
+				long long value;
+				if(!matrix_stream_next_value(stream, &value) || value < INT32_MIN || value > INT32_MAX)
+					return -1;
+				row[j] = (int) value;
+			}
+		}
+	}
+
+	if(columns < stream->columns){
+		stream->columns_read += columns;
+		if(stream->columns_read < stream->columns)
+			return rows;
+		stream->columns_read = 0;
+	}
+	stream->rows_read += rows;
+	return rows;
+};
+
+// Same as matrix_count_rows_below for the matrix of the stream, counts are
+// added to counts. Returns false when the file is malformed. Sums of parts of
+// a wide row are added up until the row ends.
+inline bool matrix_stream_count_rows_below(MatrixStream * stream, const std::vector<long long> & thresholds, std::vector<long> & counts){
+	const long block_columns = MATRIX_STREAM_BLOCK_SIZE / sizeof(int);
+	long block_rows = std::max(1L, block_columns / std::max(1L, (stream->columns + 7) / 8 * 8));
+	bool is_wide = stream->columns > block_columns;
+	Matrix * blocks[2];
+	long block_lengths[2] = {0, 0};
+	bool is_ready[2] = {false, false};
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool is_valid = true;
+	long long row_sum = 0;
+	long row_columns = 0;
+
+	counts.resize(thresholds.size(), 0);
+	// rows without columns have no average
+	if(stream->columns == 0)
+		return true;
+	blocks[0] = get_matrix();
+	blocks[1] = get_matrix();
+
+	// reader fills blocks in turn and stops after the last one, which has
+	// length 0 or -1
+	std::thread reader([&]{
+		for(long i = 0; ; i++){
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				condition.wait(lock, [&]{ return !is_ready[i % 2]; });
+			}
+			long length = matrix_stream_read_block(stream, blocks[i % 2], block_rows, block_columns);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				block_lengths[i % 2] = length;
+				is_ready[i % 2] = true;
+			}
+			condition.notify_all();
+			if(length <= 0)
+				return;
+		}
+	});
+
+	for(long i = 0; ; i++){
+		long length;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]{ return is_ready[i % 2]; });
+			length = block_lengths[i % 2];
+		}
+		if(length <= 0){
+			is_valid = length == 0;
+			break;
+		}
+
+		if(is_wide){
+			row_sum += matrix_row_sum(blocks[i % 2], 0);
+			row_columns += blocks[i % 2]->columns;
+			if(row_columns == stream->columns){
+				for(long j = 0; j < (long) counts.size(); j++)
+					counts[j] += row_sum / stream->columns < thresholds[j];
+				row_sum = 0;
+				row_columns = 0;
+			}
+		} else {
+			std::vector<long> block_counts = matrix_count_rows_below(blocks[i % 2], thresholds);
+			for(long j = 0; j < (long) counts.size(); j++)
+				counts[j] += block_counts[j];
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			is_ready[i % 2] = false;
+		}
+		condition.notify_all();
+	}
+
+	reader.join();
+	free_matrix(blocks[0]);
+	free_matrix(blocks[1]);
+
+	return is_valid;
+};
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include "matrix.h"
+#include "random.h"
+#include "matrix_stream.h"
+
+// Writes a random matrix to a binary and a text file block by block, then
+// counts rows with average below the thresholds streaming both files and
+// compares with the counts of the matrix generated again in blocks. Prints
+// throughput of the streams, with a file bigger than memory it is the disk.
+// Build: g++ -O2 matrix_stream_benchmark.cpp -o matrix_stream_benchmark -pthread
+// Usage: ./matrix_stream_benchmark [rows] [columns] [directory]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+int main(int argc, char ** argv){
+	long rows = argc > 1 ? atol(argv[1]) : 8192;
+	long columns = argc > 2 ? atol(argv[2]) : 8191;
+	std::string directory = argc > 3 ? argv[3] : "/tmp";
+	std::string paths[2] = {directory + "/matrix_stream_benchmark.bin", directory + "/matrix_stream_benchmark.txt"};
+	long block_rows = std::max(1L, (long) MATRIX_STREAM_BLOCK_SIZE / (columns * (long) sizeof(int)));
+	Matrix * block = get_matrix();
+	RandomGenerator generator;
+	MatrixFileHeader header = {{'M', 'A', 'T', 'R', 'I', 'X', '0', '1'}, rows, columns};
+	std::vector<long long> thresholds;
+	std::vector<long> expected(16, 0);
+	FILE * files[2] = {fopen(paths[0].c_str(), "wb"), fopen(paths[1].c_str(), "w")};
+	double size = (double) rows * columns * sizeof(int) / 1e9;
+
+	for(long i = 0; i < 16; i++)
+		thresholds.push_back(-80 + i * 10);
+
+	fwrite(&header, sizeof(header), 1, files[0]);
+	fprintf(files[1], "%ld %ld\n", rows, columns);
+	random_seed(&generator, 83663);
+	for(long first_row = 0; first_row < rows; first_row += block_rows){
+		if(!matrix_resize(block, std::min(block_rows, rows - first_row), columns)){
+			std::cout << "Error: Can not allocate block\n";
+			return 1;
+		}
+		for(long i = 0; i < block->rows; i++)
+			random_fill_uniform(&generator, matrix_row(block, i), columns, -100 - (int) (first_row + i) % 50, 50);
+
+		std::vector<long> counts = matrix_count_rows_below(block, thresholds);
+		for(long i = 0; i < 16; i++)
+			expected[i] += counts[i];
+
+		for(long i = 0; i < block->rows; i++){
+			int * row = matrix_row(block, i);
+			fwrite(row, sizeof(int), columns, files[0]);
+			for(long j = 0; j < columns; j++)
+				fprintf(files[1], j + 1 < columns ? "%d " : "%d\n", row[j]);
+		}
+	}
+	fclose(files[0]);
+	fclose(files[1]);
+	free_matrix(block);
+
+	std::cout << "matrix: " << rows << " x " << columns << ", " << size << " GB of ints\n";
+	for(int format = 0; format < 2; format++){
+		MatrixStream * stream = open_matrix_stream(paths[format].c_str());
+		std::vector<long> counts;
+		double start = get_seconds(), time;
+		bool is_valid = stream != NULL && matrix_stream_count_rows_below(stream, thresholds, counts) && counts == expected;
+
+		time = get_seconds() - start;
+		std::cout << (format == 0 ? "binary" : "text") << " stream: " << time * 1000 << " ms, " << size / time << " GB/s of ints "
+			<< (is_valid ? "ok" : "INVALID") << "\n";
+
+		if(stream != NULL)
+			close_matrix_stream(stream);
+		unlink(paths[format].c_str());
+	}
+};
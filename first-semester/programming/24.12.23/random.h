@@ -0,0 +1,228 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define RANDOM_AVX2
+#endif
+
+// Seedable xoshiro256** generator with unbiased integers in a range, for
+// filling big matrices. Integers come from Lemire's multiply-shift reduction:
+// the high half of random * range is the value, the few products whose low
+// half is below 2^32 % range are rejected, so every value has the same
+// chance. Bulk fills run four generators in AVX2 lanes and split big buffers
+// into parts with their own streams.
+
+// Values of a part of random_fill_uniform_parallel, parts and their streams
+// do not depend on amount of threads, so a seed always gives the same values.
+#define RANDOM_PART_SIZE (1 << 20)
+
+struct RandomGenerator {
+	uint64_t state[4];
+};
+
+inline uint64_t random_rotl(uint64_t x, int k){
+	return (x << k) | (x >> (64 - k));
+};
+
+// State is filled with splitmix64 of the seed, it is never all zeros.
+inline void random_seed(RandomGenerator * generator, uint64_t seed){
+	for(int i = 0; i < 4; i++){
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		generator->state[i] = z ^ (z >> 31);
+	}
+};
+
+inline uint64_t random_next(RandomGenerator * generator){
+	uint64_t * s = generator->state;
+	uint64_t result = random_rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = random_rotl(s[3], 45);
+
+	return result;
+};
+
+inline void random_jump_by(RandomGenerator * generator, const uint64_t * polynomial){
+	uint64_t state[4] = {0, 0, 0, 0};
+
+	for(int i = 0; i < 4; i++)
+		for(int b = 0; b < 64; b++){
+			if(polynomial[i] & (1ULL << b))
+				for(int j = 0; j < 4; j++)
+					state[j] ^= generator->state[j];
+			random_next(generator);
+		}
+
+	for(int j = 0; j < 4; j++)
+		generator->state[j] = state[j];
+};
+
+// Same as 2^128 calls of random_next, for streams of AVX2 lanes.
+inline void random_jump(RandomGenerator * generator){
+	static const uint64_t polynomial[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+	random_jump_by(generator, polynomial);
+};
+
+// Same as 2^192 calls of random_next, for streams of parts.
+inline void random_long_jump(RandomGenerator * generator){
+	static const uint64_t polynomial[4] = {0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL};
+	random_jump_by(generator, polynomial);
+};
+
+// Random integer from from to to inclusive, from has to be not greater than to.
+inline int random_uniform(RandomGenerator * generator, int from, int to){
+	uint64_t range = (uint64_t) ((int64_t) to - from) + 1;
+	uint64_t x = random_next(generator) >> 32;
+	uint64_t m = x * range;
+
+	if(range == (1ULL << 32))
+		return (int) (uint32_t) ((uint32_t) from + x);
+
+	if((uint32_t) m < range){
+		uint32_t threshold = (uint32_t) (-(uint32_t) range) % (uint32_t) range;
+		while((uint32_t) m < threshold){
+			x = random_next(generator) >> 32;
+			m = x * range;
+		}
+	}
+
+	return (int) (uint32_t) ((uint32_t) from + (uint32_t) (m >> 32));
+};
+
+inline void random_fill_uniform_scalar(RandomGenerator * generator, int * buffer, long length, int from, int to){
+	for(long i = 0; i < length; i++)
+		buffer[i] = random_uniform(generator, from, to);
+};
+
+#ifdef RANDOM_AVX2
+
+__attribute__((target("avx2")))
+inline __m256i random_rotl_avx2(__m256i x, int k){
+	return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+};
+
+// Lane k of the four generators starts from generator jumped k times, the
+// generator itself is jumped four times and draws values for rejected
+// products. Every step gives 8 values of 32 bits.
+__attribute__((target("avx2")))
+inline void random_fill_uniform_avx2(RandomGenerator * generator, int * buffer, long length, int from, int to){
+	uint64_t range = (uint64_t) ((int64_t) to - from) + 1;
+	alignas(32) uint64_t lanes[4][4];
+	long i = 0;
+
+	if(range == (1ULL << 32) || length < 8){
+		random_fill_uniform_scalar(generator, buffer, length, from, to);
+		return;
+	}
+
+	for(int lane = 0; lane < 4; lane++){
+		for(int j = 0; j < 4; j++)
+			lanes[j][lane] = generator->state[j];
+		random_jump(generator);
+	}
+
+	__m256i s0 = _mm256_load_si256((const __m256i *) lanes[0]);
+	__m256i s1 = _mm256_load_si256((const __m256i *) lanes[1]);
+	__m256i s2 = _mm256_load_si256((const __m256i *) lanes[2]);
+	__m256i s3 = _mm256_load_si256((const __m256i *) lanes[3]);
+	__m256i range_vector = _mm256_set1_epi64x(range);
+	__m256i first = _mm256_set1_epi32(from);
+	// unsigned compare as signed after flipping the sign bits
+	__m256i sign = _mm256_set1_epi32(INT32_MIN);
+	__m256i threshold = _mm256_set1_epi32((int) (((uint32_t) (-(uint32_t) range) % (uint32_t) range) ^ 0x80000000u));
+	__m256i high_mask = _mm256_set1_epi64x((long long) 0xffffffff00000000ULL);
+
+	for(; i + 8 <= length; i += 8){
+		__m256i s1_5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+		__m256i rotated = random_rotl_avx2(s1_5, 7);
+		__m256i x = _mm256_add_epi64(_mm256_slli_epi64(rotated, 3), rotated);
+		__m256i t = _mm256_slli_epi64(s1, 17);
+
+		s2 = _mm256_xor_si256(s2, s0);
+		s3 = _mm256_xor_si256(s3, s1);
+		s1 = _mm256_xor_si256(s1, s2);
+		s0 = _mm256_xor_si256(s0, s3);
+		s2 = _mm256_xor_si256(s2, t);
+		s3 = random_rotl_avx2(s3, 45);
+
+		// products of even and odd 32-bit halves with the range
+		__m256i even = _mm256_mul_epu32(x, range_vector);
+		__m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), range_vector);
+		__m256i values = _mm256_blendv_epi8(_mm256_srli_epi64(even, 32), odd, high_mask);
+		__m256i lows = _mm256_blendv_epi8(even, _mm256_slli_epi64(odd, 32), high_mask);
+		int rejected = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(threshold, _mm256_xor_si256(lows, sign))));
+
+		_mm256_storeu_si256((__m256i *)(buffer + i), _mm256_add_epi32(values, first));
+		while(rejected != 0){
+			buffer[i + __builtin_ctz(rejected)] = random_uniform(generator, from, to);
+			rejected &= rejected - 1;
+		}
+	}
+
+	random_fill_uniform_scalar(generator, buffer + i, length - i, from, to);
+};
+
+#endif
+
+// Fills buffer with random integers from from to to inclusive, AVX2 kernel
+// is used when the CPU supports it.
+inline void random_fill_uniform(RandomGenerator * generator, int * buffer, long length, int from, int to){
+#ifdef RANDOM_AVX2
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	if(has_avx2){
+		random_fill_uniform_avx2(generator, buffer, length, from, to);
+		return;
+	}
+#endif
+
+	random_fill_uniform_scalar(generator, buffer, length, from, to);
+};
+
+// Fills parts first_part, first_part + part_step and so on. Stream is only
+// long jumped, so it is the generator long jumped i times at part i, and the
+// part is filled from a copy of it.
+inline void random_fill_uniform_parts(RandomGenerator stream, int * buffer, long length, int from, int to, long first_part, long part_step){
+	long part_amount = (length + RANDOM_PART_SIZE - 1) / RANDOM_PART_SIZE;
+
+	for(long i = 0; i < first_part; i++)
+		random_long_jump(&stream);
+
+	for(long i = first_part; i < part_amount; i += part_step){
+		RandomGenerator generator = stream;
+
+		random_fill_uniform(&generator, buffer + i * RANDOM_PART_SIZE, std::min(length - i * RANDOM_PART_SIZE, (long) RANDOM_PART_SIZE), from, to);
+		for(long j = 0; j < part_step; j++)
+			random_long_jump(&stream);
+	}
+};
+
+// Same as random_fill_uniform for buffers of any size. Part i of
+// RANDOM_PART_SIZE values uses the generator long jumped i times, parts are
+// divided between threads. The generator is moved past all used streams.
+inline void random_fill_uniform_parallel(RandomGenerator * generator, int * buffer, long length, int from, int to){
+	long part_amount = (length + RANDOM_PART_SIZE - 1) / RANDOM_PART_SIZE;
+	long thread_amount = std::min((long) std::max(1u, std::thread::hardware_concurrency()), part_amount);
+	std::vector<std::thread> threads;
+
+	for(long i = 1; i < thread_amount; i++)
+		threads.push_back(std::thread(random_fill_uniform_parts, *generator, buffer, length, from, to, i, thread_amount));
+	if(thread_amount > 0)
+		random_fill_uniform_parts(*generator, buffer, length, from, to, 0, thread_amount);
+	for(auto & thread : threads)
+		thread.join();
+
+	for(long i = 0; i < std::max(part_amount, 1L); i++)
+		random_long_jump(generator);
+};
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include "random.h"
+
+// Times filling a buffer with random values from 1 to 100: rand() loop the
+// lab had, scalar generator, AVX2 kernel and parallel fill. Then checks that
+// every value of a small range comes out equally often (chi-square of the
+// counts) and that the parallel fill gives the same values for a seed.
+// Build: g++ -O2 random_benchmark.cpp -o random_benchmark -pthread
+// Usage: ./random_benchmark [values]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+// Chi-square of counts of values from 0 to range - 1 in buffer.
+double get_chi_square(const int * buffer, long length, int range){
+	std::vector<long> counts(range, 0);
+	double expected = (double) length / range, chi_square = 0;
+
+	for(long i = 0; i < length; i++)
+		counts[buffer[i]]++;
+	for(long count : counts)
+		chi_square += (count - expected) * (count - expected) / expected;
+
+	return chi_square;
+};
+
+int main(int argc, char ** argv){
+	long length = argc > 1 ? atol(argv[1]) : 100000000;
+	std::vector<int> buffer(length), copy(length);
+	RandomGenerator generator, copy_generator;
+	double start, rand_time, scalar_time, avx2_time, parallel_time;
+	bool is_valid = true;
+	int from = 1, to = 100;
+
+	srand(83663);
+	start = get_seconds();
+	for(long i = 0; i < length; i++){
+		int k = 0;
+		while(k == 0){
+			k = (rand() % to) + from;
+			if(k >= from && k <= to)
+				buffer[i] = k;
+			else
+				k = 0;
+		}
+	}
+	rand_time = get_seconds() - start;
+
+	random_seed(&generator, 83663);
+	start = get_seconds();
+	random_fill_uniform_scalar(&generator, buffer.data(), length, from, to);
+	scalar_time = get_seconds() - start;
+
+	start = get_seconds();
+	random_fill_uniform(&generator, buffer.data(), length, from, to);
+	avx2_time = get_seconds() - start;
+
+	random_seed(&generator, 83663);
+	start = get_seconds();
+	random_fill_uniform_parallel(&generator, buffer.data(), length, from, to);
+	parallel_time = get_seconds() - start;
+
+	random_seed(&copy_generator, 83663);
+	random_fill_uniform_parallel(&copy_generator, copy.data(), length, from, to);
+	is_valid = memcmp(buffer.data(), copy.data(), length * sizeof(int)) == 0 &&
+		memcmp(generator.state, copy_generator.state, sizeof(generator.state)) == 0;
+	for(long i = 0; i < length && is_valid; i++)
+		is_valid = buffer[i] >= from && buffer[i] <= to;
+
+	std::cout << "values: " << length << "\n"
+		<< "rand() loop: " << rand_time * 1000 << " ms\n"
+		<< "random_fill_uniform_scalar: " << scalar_time * 1000 << " ms\n"
+		<< "random_fill_uniform: " << avx2_time * 1000 << " ms\n"
+		<< "random_fill_uniform_parallel: " << parallel_time * 1000 << " ms\n"
+		<< (is_valid ? "ok" : "INVALID") << "\n";
+
+	// 2^32 is not a multiple of 3 or 7, a biased reduction shows up as
+	// chi-square far above amount of values in the range
+	for(int range : {3, 7, 100}){
+		random_fill_uniform_parallel(&generator, buffer.data(), length, 0, range - 1);
+		std::cout << "chi-square of " << range << " values: " << get_chi_square(buffer.data(), length, range)
+			<< " (expected about " << range - 1 << ")\n";
+	}
+};
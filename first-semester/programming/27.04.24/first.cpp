@@ -1,23 +1,363 @@
 #include <stdio.h>
-#include <iostream>
-#include <fstream>
-#include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <algorithm>
 
-#ifdef __unix
-#define fopen_s(pFile,filename,mode) ((*(pFile))=fopen((filename),(mode)))==NULL
+#ifdef __SSE2__
+#include <emmintrin.h>
 #endif
 
+// Deletes every occurrence of the given strings from a file and writes the
+// rest into another file. Strings are given after the file names or entered
+// on one line separated by spaces. A regular file is mapped, other input
+// like a pipe is read in chunks, output is written in big blocks.
+// Going from the start, the occurrence which ends first is deleted, of those
+// which end at the same place the longest one, and search goes on after it.
+// Build: g++ -O2 first.cpp -o first
+// Usage: ./first [input|- [output|- [strings]]]
+
+#define DELETE_CHUNK_SIZE (16 << 20)
+
+// One string is searched directly, more strings with an Aho-Corasick
+// automaton: a trie of the strings where every state has a transition for
+// every byte, so each byte of input is one table lookup.
+struct PatternDeleter {
+	std::vector<std::string> patterns;
+	std::vector<int> transitions;
+	// length of the longest string ending in a state, 0 when none does
+	std::vector<int> match_lengths;
+	std::vector<int> depths;
+	int state;
+	long max_length;
+};
+
+// Output is kept in buffer until it is full. Bytes of a possible match are
+// already in buffer when the match is found and are taken back from its end.
+struct DeleteOutput {
+	int fd;
+	std::vector<char> buffer;
+	long length;
+	bool is_failed;
+};
+
+PatternDeleter get_pattern_deleter(const std::vector<std::string> & patterns){
+	PatternDeleter deleter;
+
+	for(auto & pattern : patterns)
+		if(!pattern.empty())
+			deleter.patterns.push_back(pattern);
+	deleter.state = 0;
+	deleter.max_length = 0;
+	for(auto & pattern : deleter.patterns)
+		deleter.max_length = std::max(deleter.max_length, (long) pattern.size());
+	if(deleter.patterns.size() < 2)
+		return deleter;
+
+	// trie, -1 for missing transitions
+	deleter.transitions.assign(256, -1);
+	deleter.match_lengths.assign(1, 0);
+	deleter.depths.assign(1, 0);
+	for(auto & pattern : deleter.patterns){
+		int state = 0;
+
+		for(unsigned char c : pattern){
+			if(deleter.transitions[state * 256 + c] < 0){
+				deleter.transitions[state * 256 + c] = deleter.depths.size();
+				deleter.transitions.resize(deleter.transitions.size() + 256, -1);
+				deleter.match_lengths.push_back(0);
+				deleter.depths.push_back(deleter.depths[state] + 1);
+			}
+			state = deleter.transitions[state * 256 + c];
+		}
+		deleter.match_lengths[state] = pattern.size();
+	}
+
+	// missing transitions go where the failure link of the state goes,
+	// states are visited by depth, so that state is complete already
+	std::vector<int> failures(deleter.depths.size(), 0);
+	std::queue<int> states;
+
+	for(int c = 0; c < 256; c++){
+		int & next = deleter.transitions[c];
+		if(next < 0)
+			next = 0;
+		else
+			states.push(next);
+	}
+	while(!states.empty()){
+		int state = states.front();
+		states.pop();
+
+		if(deleter.match_lengths[state] == 0)
+			deleter.match_lengths[state] = deleter.match_lengths[failures[state]];
+		for(int c = 0; c < 256; c++){
+			int & next = deleter.transitions[state * 256 + c];
+			int failure_next = deleter.transitions[failures[state] * 256 + c];
+
+			if(next < 0){
+				next = failure_next;
+			} else {
+				failures[next] = failure_next;
+				states.push(next);
+			}
+		}
+	}
+
+	// after a match the automaton starts again, so states where one ends
+	// go on like the first state
+	for(size_t state = 1; state < deleter.depths.size(); state++)
+		if(deleter.match_lengths[state] > 0)
+			std::copy(deleter.transitions.begin(), deleter.transitions.begin() + 256, deleter.transitions.begin() + state * 256);
+
+	// transitions hold the start of the next state's row, which saves a
+	// multiplication between the lookups of two bytes
+	for(int & next : deleter.transitions)
+		next *= 256;
+
+	return deleter;
+};
+
+DeleteOutput get_delete_output(int fd, long max_length){
+	DeleteOutput out;
+
+	out.fd = fd;
+	out.buffer.resize(DELETE_CHUNK_SIZE + max_length);
+	out.length = 0;
+	out.is_failed = false;
+
+	return out;
+};
+
+bool write_all(int fd, const char * data, long length){
+	while(length > 0){
+		long written = write(fd, data, length);
+		if(written < 0)
+			return false;
+		data += written;
+		length -= written;
+	}
+
+	return true;
+};
+
+// Writes all of buffer except its last kept bytes, which are moved to its start.
+void output_flush(DeleteOutput & out, long kept){
+	if(!out.is_failed && !write_all(out.fd, out.buffer.data(), out.length - kept))
+		out.is_failed = true;
+	memmove(out.buffer.data(), out.buffer.data() + out.length - kept, kept);
+	out.length = kept;
+};
+
+void output_write(DeleteOutput & out, const char * data, long length){
+	if(out.length + length > (long) out.buffer.size())
+		output_flush(out, 0);
+	if(length > (long) out.buffer.size()){
+		if(!out.is_failed && !write_all(out.fd, data, length))
+			out.is_failed = true;
+		return;
+	}
+	memcpy(out.buffer.data() + out.length, data, length);
+	out.length += length;
+};
+
+// Occurrences have to start before length - pattern length + 1, so unless
+// is_last the end of data which may be the start of one is left. With SSE2
+// positions where 16 first bytes and 16 last bytes of the pattern both match
+// are found at once and only those are compared, without SSE2 memchr finds
+// the first byte. Returns amount of data used.
+long delete_pattern(const std::string & pattern, const char * data, long length, bool is_last, DeleteOutput & out){
+	long pattern_length = pattern.size(), limit = length - pattern_length + 1;
+	long i = 0, from = 0, used;
+
+#ifdef __SSE2__
+	const __m128i first = _mm_set1_epi8(pattern[0]);
+	const __m128i last = _mm_set1_epi8(pattern[pattern_length - 1]);
+
+	while(i + 16 <= limit){
+		__m128i first_equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), first);
+		__m128i last_equal = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i + pattern_length - 1)), last);
+		unsigned int mask = _mm_movemask_epi8(_mm_and_si128(first_equal, last_equal));
+
+		for(; mask != 0; mask &= mask - 1){
+			long start = i + __builtin_ctz(mask);
+			if(start >= from && memcmp(data + start, pattern.data(), pattern_length) == 0){
+				output_write(out, data + from, start - from);
+				from = start + pattern_length;
+			}
+		}
+		i = std::max(i + 16, from);
+	}
+#endif
+
+	while(i < limit){
+		const char * found = (const char *) memchr(data + i, pattern[0], limit - i);
+		if(found == NULL)
+			break;
+		i = found - data;
+		if(memcmp(data + i, pattern.data(), pattern_length) == 0){
+			output_write(out, data + from, i - from);
+			i = from = i + pattern_length;
+		} else {
+			i++;
+		}
+	}
+
+	used = is_last ? length : std::max(from, std::max(limit, 0L));
+	output_write(out, data + from, used - from);
+
+	return used;
+};
+
+// Every byte is written to output and a match takes back as many bytes as
+// it is long, without a branch. Bytes of the current state could still be
+// part of a match, so they stay in output until is_last.
+void delete_patterns_automaton(PatternDeleter & deleter, const char * data, long length, bool is_last, DeleteOutput & out){
+	const int * transitions = deleter.transitions.data();
+	const int * match_lengths = deleter.match_lengths.data();
+	int state = deleter.state * 256;
+	long i = 0;
+
+	while(i < length){
+		long n = out.length, end = i + std::min(length - i, (long) out.buffer.size() - n);
+		char * buffer = out.buffer.data();
+
+		for(; i < end; i++){
+			unsigned char c = data[i];
+
+			buffer[n++] = c;
+			state = transitions[state + c];
+			n -= match_lengths[state / 256];
+		}
+		out.length = n;
+		if(i < length)
+			output_flush(out, match_lengths[state / 256] > 0 ? 0 : deleter.depths[state / 256]);
+	}
+
+	deleter.state = state / 256;
+	if(is_last)
+		output_flush(out, 0);
+};
+
+// Returns amount of data used, the rest has to be given again with the
+// next data.
+long delete_patterns(PatternDeleter & deleter, const char * data, long length, bool is_last, DeleteOutput & out){
+	if(deleter.patterns.empty()){
+		output_write(out, data, length);
+		return length;
+	}
+	if(deleter.patterns.size() == 1)
+		return delete_pattern(deleter.patterns[0], data, length, is_last, out);
+
+	delete_patterns_automaton(deleter, data, length, is_last, out);
+	return length;
+};
+
+// Reads until buffer is full or input ends, -1 on error.
+long read_all(int fd, char * buffer, long length){
+	long total = 0, count;
+
+	while(total < length && (count = read(fd, buffer + total, length - total)) != 0){
+		if(count < 0)
+			return -1;
+		total += count;
+	}
+
+	return total;
+};
+
+// Returns false when input can not be read or output can not be written.
+bool delete_from_file(PatternDeleter & deleter, int fd, DeleteOutput & out){
+	struct stat file_stat;
+
+	if(fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0){
+		void * data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(data != MAP_FAILED){
+			madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+			delete_patterns(deleter, (const char *) data, file_stat.st_size, true, out);
+			munmap(data, file_stat.st_size);
+			output_flush(out, 0);
+			return !out.is_failed;
+		}
+	}
+
+	// a match may start in one chunk and end in the next one, what is not
+	// used of a chunk is moved before the next one
+	std::vector<char> buffer(DELETE_CHUNK_SIZE + deleter.max_length);
+	long kept = 0, length;
+	bool is_last = false;
+
+	while(!is_last){
+		if((length = read_all(fd, buffer.data() + kept, DELETE_CHUNK_SIZE)) < 0)
+			return false;
+		is_last = length < DELETE_CHUNK_SIZE;
+		length += kept;
+		kept = length - delete_patterns(deleter, buffer.data(), length, is_last, out);
+		memmove(buffer.data(), buffer.data() + length - kept, kept);
+	}
+
+	output_flush(out, 0);
+	return !out.is_failed;
+};
+
+int main(int argc, char ** argv){
+	const char * input_path = argc > 1 ? argv[1] : "rest_strings.txt";
+	const char * output_path = argc > 2 ? argv[2] : "new_file.txt";
+	std::vector<std::string> patterns(argv + std::min(argc, 3), argv + argc);
+	int input, output;
+
+	if(patterns.empty()){
+		std::string line, pattern;
+
+		if(strcmp(input_path, "-") == 0){
+			fprintf(stderr, "Error: Strings to delete have to be given after the file names to read standard input\n");
+			return 1;
+		}
+		fprintf(stderr, "Enter strings to delete: ");
+		std::getline(std::cin, line);
+		for(size_t i = 0; i <= line.size(); i++){
+			if(i == line.size() || isspace((unsigned char) line[i])){
+				if(!pattern.empty())
+					patterns.push_back(pattern);
+				pattern.clear();
+			} else {
+				pattern += line[i];
+			}
+		}
+	}
+
+	input = strcmp(input_path, "-") == 0 ? 0 : open(input_path, O_RDONLY);
+	if(input < 0){
+		fprintf(stderr, "Error: Can not open %s\n", input_path);
+		return 1;
+	}
+	output = strcmp(output_path, "-") == 0 ? 1 : open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(output < 0){
+		fprintf(stderr, "Error: Can not open %s\n", output_path);
+		return 1;
+	}
 
-int main(){
-	FILE *fp, *fp2;
-	fopen_s(&fp, "rest_strings.txt", "r");
+	PatternDeleter deleter = get_pattern_deleter(patterns);
+	DeleteOutput out = get_delete_output(output, deleter.max_length);
 
-	char strToDelete[255];
-	char str[255];
-	printf("Enter string to delete: ");
-	scanf("%s", strToDelete);
+	if(!delete_from_file(deleter, input, out)){
+		fprintf(stderr, "Error: Can not delete strings from %s\n", input_path);
+		return 1;
+	}
 
-	int len = strlen(strToDelete);
+	close(input);
+	if(close(output) != 0 && output != 1){
+		fprintf(stderr, "Error: Can not write %s\n", output_path);
+		return 1;
+	}
 
+	return 0;
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <iostream>
 #include <string>
+#include "reduce.h"
 
 void my_function();
 void my_function(char a);
@@ -14,9 +15,6 @@ void print_txt(std::string & str);
 
 void string_modifier(std::string & str);
 
-template <class Type>
-Type maxT(Type a, Type b);
-
 
 int main(){
 	char x = 'o';
@@ -42,17 +40,12 @@ int main(){
 	int max = maxT(10, 1);
 	std::cout << "Max item " << max << std::endl;
 
-	
+	int items[] = {4, -2, 9, 0, 9, -2};
+	std::cout << "Max of items " << maxT(items) << ", min of items " << minT(items)
+		<< " at " << argmin(items) << ", sum " << sum(items) << ", average " << average(items) << std::endl;
 
-}
+	
 
-template<class Type>
-Type maxT(Type a, Type b){
-	if(a > b){
-		return a;
-	} else {
-		return b;
-	}
 }
 
 void my_function(){
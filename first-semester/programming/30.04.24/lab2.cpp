@@ -1,143 +1,163 @@
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
+#include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Collapses repeated spaces into one space. Without arguments trims three
+// lines of input, with a file collapses it chunk by chunk into the output
+// file or stdout, runs of spaces may continue from one chunk into the next.
+// Build: g++ -O2 lab2.cpp -o lab2
+// Usage: ./lab2 [input [output]]
+
+#define SPACE_CHUNK_SIZE (1 << 20)
+
+long collapseSpaces(char * data, long length, bool & isAfterSpace);
+bool collapseSpacesFile(FILE * input, FILE * output);
 void spaceTrim(char * str);
 void spaceTrim(std::string &str);
 
-int main(){
+int main(int argc, char ** argv){
 	int studentCode = 86336;
 	int taskVarCount = 25;
 	int stringsAmount = 0;
 
-	std::cout << "Program number: " << studentCode % taskVarCount << std::endl;
-	//Function deletes repeated spaces (replaces multiple spaces with single space) in the string.
-	
-	char ** c_strgs = (char **) malloc(sizeof(char *) * 3);
-
-	// Gather strings	
-	do{
-		char * str = (char *) malloc(1000);
-
-		// get c string
-		char c;
-		int i = 0;
-		while((c = getchar()) != '\n'){
-			*(str + i) = c;
-			i++;
+	if(argc > 1){
+		FILE * input = fopen(argv[1], "rb");
+		FILE * output = argc > 2 ? fopen(argv[2], "wb") : stdout;
+
+		if(input == NULL || output == NULL){
+			std::cerr << "Error: Can not open " << (input == NULL ? argv[1] : argv[2]) << std::endl;
+			return 1;
 		}
-		*(str + i) = '\0';
+		if(!collapseSpacesFile(input, output) || fclose(output) != 0){
+			std::cerr << "Error: Can not collapse " << argv[1] << std::endl;
+			return 1;
+		}
+		fclose(input);
 
-		*(c_strgs + sizeof(char **) * stringsAmount) = str;
-		stringsAmount++;
-	} while (stringsAmount < 3);
+		return 0;
+	}
+
+	std::cout << "Program number: " << studentCode % taskVarCount << std::endl;
+	//Function deletes repeated spaces (replaces multiple spaces with single space) in the string.
 
-	// Copy c strings to new array as c++ strings
-	std::string * cpp_strgs = (std::string *) malloc(sizeof(std::string) * 3);
+	// Gather strings, the same line as c string and c++ string
+	std::string cpp_strgs[3];
+	std::vector<char> c_strgs[3];
 
-	int i = 0;
-	while(i < 3){
-		std::string s = *(c_strgs + sizeof(char *) * i);
-		*(cpp_strgs + i * sizeof(std::string *)) = s;
-		i++;
+	while(stringsAmount < 3 && std::getline(std::cin, cpp_strgs[stringsAmount])){
+		const char * str = cpp_strgs[stringsAmount].c_str();
+		c_strgs[stringsAmount].assign(str, str + cpp_strgs[stringsAmount].size() + 1);
+		stringsAmount++;
 	}
-	
+
 	// Trim strings
-	i = 0;
-	while(i < 3){
-		spaceTrim((char *) *(c_strgs + sizeof(char *) * i));
-		spaceTrim(*(cpp_strgs + i * sizeof(std::string *)));
+	int i = 0;
+	while(i < stringsAmount){
+		spaceTrim(c_strgs[i].data());
+		spaceTrim(cpp_strgs[i]);
 		i++;
 	}
 
-	// Print strings 
-	i = 0;	
-	while(i < 3){
-		std::cout << *(c_strgs + sizeof(char **) * i) << std::endl;
-		std::cout << *(cpp_strgs + i * sizeof(std::string *)) << std::endl;
+	// Print strings
+	i = 0;
+	while(i < stringsAmount){
+		std::cout << c_strgs[i].data() << std::endl;
+		std::cout << cpp_strgs[i] << std::endl;
 		i++;
 	}
 
 	return 0;
 }
 
-void spaceTrim(char * str) {
-	bool spaceEncountered = false;
-
-	char * str_end = 0, i = 0;
-	int space_amount = 0;
-
-
-	while(*(str + i++) != '\0');
-	str_end = str + i;
-
-	while(*(str++) != '\0'){
-		if(spaceEncountered){
-			int j, i = 0;
-			char * start = str;
-
-			while(*(str + i) != '\0' && *(str + i) == ' ') i++;
-
-			space_amount+=i;
-
-			j = i;
-
-			while(*(str + i) != '\0'){
-				*(start++) = *(str + i);
-				i++;
+// Removes every space which follows a space in data in place and returns the
+// new length. isAfterSpace tells whether the byte before data was a space and
+// is set for the last byte, so a text can be collapsed in parts. With SSE2 16
+// bytes are compared at a time, blocks without repeated spaces are stored
+// whole, other blocks store one 16 byte piece for each kept run of bytes.
+// Pieces reach into the next block, so it is loaded before they are stored.
+long collapseSpaces(char * data, long length, bool & isAfterSpace){
+	unsigned int carry = isAfterSpace;
+	long read = 0, write = 0;
+
+#ifdef __SSE2__
+	if(length >= 32){
+		const __m128i spaces = _mm_set1_epi8(' ');
+		__m128i next = _mm_loadu_si128((const __m128i *) data);
+
+		for(; read + 32 <= length; read += 16){
+			__m128i block = next;
+			unsigned int spaceMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, spaces));
+			unsigned int dropMask = spaceMask & (spaceMask << 1 | carry);
+
+			next = _mm_loadu_si128((const __m128i *)(data + read + 16));
+			carry = spaceMask >> 15;
+			if(dropMask == 0){
+				_mm_storeu_si128((__m128i *)(data + write), block);
+				write += 16;
+			} else if(dropMask != 0xffff){
+				char blocks[32];
+				int from = 0;
+
+				_mm_storeu_si128((__m128i *) blocks, block);
+				_mm_storeu_si128((__m128i *)(blocks + 16), next);
+				for(; dropMask != 0; dropMask &= dropMask - 1){
+					int to = __builtin_ctz(dropMask);
+					_mm_storeu_si128((__m128i *)(data + write), _mm_loadu_si128((const __m128i *)(blocks + from)));
+					write += to - from;
+					from = to + 1;
+				}
+				_mm_storeu_si128((__m128i *)(data + write), _mm_loadu_si128((const __m128i *)(blocks + from)));
+				write += 16 - from;
 			}
-
-			str = str + j;
 		}
 
-		if(*str == ' ' && spaceEncountered == false){
-			spaceEncountered = true;
-		}
+		// pieces may have overwritten the block after the last one
+		_mm_storeu_si128((__m128i *)(data + read), next);
+	}
+#endif
 
-		if(*str != ' ')
-			spaceEncountered = false; 
+	for(; read < length; read++){
+		unsigned int isSpace = data[read] == ' ';
 
+		if(!(isSpace && carry))
+			data[write++] = data[read];
+		carry = isSpace;
 	}
 
-	*(str_end - space_amount - 1) = '\0';
+	isAfterSpace = carry;
+	return write;
 }
 
-void spaceTrim(std::string &str) {
-	bool spaceEncountered = false;
-
-	int indx = 0;
-	int from = -1, to = -1;
-	char c;
+// Returns false when input can not be read or output can not be written.
+bool collapseSpacesFile(FILE * input, FILE * output){
+	std::vector<char> buffer(SPACE_CHUNK_SIZE);
+	bool isAfterSpace = false;
+	size_t length;
 
+	while((length = fread(buffer.data(), 1, buffer.size(), input)) > 0){
+		length = collapseSpaces(buffer.data(), length, isAfterSpace);
+		if(fwrite(buffer.data(), 1, length, output) != length)
+			return false;
+	}
 
-	int space_amount = 0;
-	while(str[indx++] != '\0'){
-		if(str[indx] == ' ' && spaceEncountered == false){
-			from = indx;
-			spaceEncountered = true;
-		}
-		else if(str[indx] != ' ' && spaceEncountered == true){
-			to = indx;
-			spaceEncountered = false;
-
-			if(to - from < 2){
-				from = -1;
-				to = -1;
-			}
-		} else if (spaceEncountered){
-			space_amount++;
-		}
+	return !ferror(input);
+}
 
-		if(from > -1 && to > -1){
-			str.erase(from + 1, space_amount);
-			indx = from;
-			space_amount = 0;
-			from = -1;
-			to = -1;
-		}
-	}
+void spaceTrim(char * str) {
+	bool isAfterSpace = false;
 
+	str[collapseSpaces(str, strlen(str), isAfterSpace)] = '\0';
 }
 
+void spaceTrim(std::string &str) {
+	bool isAfterSpace = false;
 
+	str.resize(collapseSpaces(&str[0], str.size(), isAfterSpace));
+}
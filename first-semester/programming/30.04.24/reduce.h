@@ -0,0 +1,291 @@
+#pragma once
+
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Reductions over arrays and contiguous containers: reduce with any
+// operation, maxT/minT, argmin/argmax, sum and average. Arrays are reduced in
+// parts of REDUCE_PART_SIZE elements and results of parts are combined in
+// order, threads only compute parts at the same time, so a result does not
+// depend on amount of threads, also for floats. Parts of arithmetic types
+// are reduced with 8 independent accumulators, which the compiler turns into
+// vector instructions, other types with one. Sums of 8 and 16-bit integers
+// are collected in narrow lanes, which hold a part without overflow, and
+// widened once per part. Arrays of REDUCE_PARALLEL_SIZE elements and more are
+// divided between threads.
+
+#define REDUCE_PART_SIZE (1 << 16)
+#define REDUCE_PARALLEL_SIZE (1 << 20)
+
+template <class Type>
+Type maxT(Type a, Type b){
+	if(a > b){
+		return a;
+	} else {
+		return b;
+	}
+}
+
+template <class Type>
+Type minT(Type a, Type b){
+	if(a < b){
+		return a;
+	} else {
+		return b;
+	}
+}
+
+// Type of sums: 64-bit for integers, double for float.
+template <class Type>
+using ReduceSum = typename std::conditional<std::is_integral<Type>::value,
+	typename std::conditional<std::is_signed<Type>::value, long long, unsigned long long>::type,
+	typename std::conditional<std::is_same<Type, float>::value, double, Type>::type>::type;
+
+template <class Type, class Result, class Operation>
+Result reduce_part(const Type * array, long length, Result initial, Operation operation){
+	if constexpr (std::is_arithmetic<Type>::value && std::is_arithmetic<Result>::value){
+		Result accumulators[8] = {initial, initial, initial, initial, initial, initial, initial, initial};
+		long i = 0;
+
+		for(; i + 8 <= length; i += 8)
+			for(int j = 0; j < 8; j++)
+				accumulators[j] = operation(accumulators[j], array[i + j]);
+		for(int j = 0; i < length; i++, j++)
+			accumulators[j] = operation(accumulators[j], array[i]);
+
+		return operation(operation(operation(accumulators[0], accumulators[1]), operation(accumulators[2], accumulators[3])),
+			operation(operation(accumulators[4], accumulators[5]), operation(accumulators[6], accumulators[7])));
+	} else {
+		Result result = initial;
+
+		for(long i = 0; i < length; i++)
+			result = operation(result, array[i]);
+
+		return result;
+	}
+}
+
+// Sum of a part of 8 or 16-bit integers. With SSE2 bytes are summed by
+// psadbw straight into 64-bit lanes and 16-bit values by pmaddwd into 32-bit
+// lanes, a part of REDUCE_PART_SIZE values adds at most 2^29 to such a lane.
+// Signed bytes and unsigned 16-bit values are moved by half of their range to
+// fit the instruction and moved back at the end. Without SSE2 the values go
+// into one 32-bit lane.
+template <class Type>
+ReduceSum<Type> sum_part_narrow(const Type * array, long length){
+	long long result = 0;
+	long i = 0;
+
+#ifdef __SSE2__
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sums = zero;
+
+	if constexpr (sizeof(Type) == 1){
+		const __m128i bias = _mm_set1_epi8(std::is_signed<Type>::value ? (char) 0x80 : 0);
+
+		for(; i + 16 <= length; i += 16)
+			sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(array + i)), bias), zero));
+		result = _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+		if(std::is_signed<Type>::value)
+			result -= 128 * i;
+	} else {
+		const __m128i bias = _mm_set1_epi16(std::is_signed<Type>::value ? 0 : (short) 0x8000);
+		const __m128i ones = _mm_set1_epi16(1);
+		int lanes[4];
+
+		for(; i + 8 <= length; i += 8)
+			sums = _mm_add_epi32(sums, _mm_madd_epi16(_mm_xor_si128(_mm_loadu_si128((const __m128i *)(array + i)), bias), ones));
+		_mm_storeu_si128((__m128i *) lanes, sums);
+		result = (long long) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+		if(!std::is_signed<Type>::value)
+			result += 32768 * i;
+	}
+#else
+	typename std::conditional<std::is_signed<Type>::value, int, unsigned int>::type lane = 0;
+
+	for(; i < length; i++)
+		lane += array[i];
+	result = lane;
+#endif
+
+	for(; i < length; i++)
+		result += array[i];
+
+	return (ReduceSum<Type>) result;
+}
+
+template <class Type>
+ReduceSum<Type> sum_part(const Type * array, long length){
+	if constexpr (std::is_integral<Type>::value && sizeof(Type) <= 2 && !std::is_same<Type, bool>::value)
+		return sum_part_narrow(array, length);
+	else
+		return reduce_part(array, length, (ReduceSum<Type>) 0, [](ReduceSum<Type> a, ReduceSum<Type> b){ return a + b; });
+}
+
+// Reduces every part of length elements with part_reduce(first, length) on
+// the given amount of threads and combines the results in order.
+template <class Result, class PartReduce, class Operation>
+Result reduce_parts_with_threads(long length, Result initial, PartReduce part_reduce, Operation operation, long thread_amount){
+	long part_amount = (length + REDUCE_PART_SIZE - 1) / REDUCE_PART_SIZE;
+	std::vector<Result> results(part_amount, initial);
+	std::vector<std::thread> threads;
+	Result result = initial;
+
+	auto reduce_parts = [&](long first_part, long last_part){
+		for(long i = first_part; i < last_part; i++)
+			results[i] = part_reduce(i * REDUCE_PART_SIZE, std::min(length - i * REDUCE_PART_SIZE, (long) REDUCE_PART_SIZE));
+	};
+
+	thread_amount = std::max(1L, std::min(thread_amount, part_amount));
+	for(long i = 1; i < thread_amount; i++)
+		threads.push_back(std::thread(reduce_parts, part_amount * i / thread_amount, part_amount * (i + 1) / thread_amount));
+	reduce_parts(0, part_amount / thread_amount);
+	for(auto & thread : threads)
+		thread.join();
+
+	for(long i = 0; i < part_amount; i++)
+		result = i == 0 ? results[0] : operation(result, results[i]);
+
+	return result;
+}
+
+// Same as reduce with the given amount of threads.
+template <class Type, class Result, class Operation>
+Result reduce_with_threads(const Type * array, long length, Result initial, Operation operation, long thread_amount){
+	return reduce_parts_with_threads(length, initial,
+		[&](long first, long part_length){ return reduce_part(array + first, part_length, initial, operation); }, operation, thread_amount);
+}
+
+// Amount of threads for an array of length elements.
+inline long reduce_thread_amount(long length){
+	return length >= REDUCE_PARALLEL_SIZE ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+}
+
+// Reduces array with operation, which takes (Result, Type) and (Result,
+// Result), has to be associative and initial has to be its identity, like 0
+// for + or the lowest value for maxT.
+template <class Type, class Result, class Operation>
+Result reduce(const Type * array, long length, Result initial, Operation operation){
+	return reduce_with_threads(array, length, initial, operation, reduce_thread_amount(length));
+}
+
+// Greatest element, lowest value of the type for an empty array.
+template <class Type>
+Type maxT(const Type * array, long length){
+	return reduce(array, length, std::numeric_limits<Type>::lowest(), [](Type a, Type b){ return maxT(a, b); });
+}
+
+// Lowest element, greatest value of the type for an empty array.
+template <class Type>
+Type minT(const Type * array, long length){
+	return reduce(array, length, std::numeric_limits<Type>::max(), [](Type a, Type b){ return minT(a, b); });
+}
+
+template <class Type>
+ReduceSum<Type> sum(const Type * array, long length){
+	return reduce_parts_with_threads(length, (ReduceSum<Type>) 0, [array](long first, long part_length){ return sum_part(array + first, part_length); },
+		[](ReduceSum<Type> a, ReduceSum<Type> b){ return a + b; }, reduce_thread_amount(length));
+}
+
+// 0 for an empty array.
+template <class Type>
+double average(const Type * array, long length){
+	return length == 0 ? 0 : (double) sum(array, length) / length;
+}
+
+// Index of the first element which is lower (is_max false) or greater
+// (is_max true) than all elements before it and not exceeded after it, -1 for
+// an empty array. A part finds its best value with the accumulators and then
+// the first element equal to it, NaN is never better than a number, like in a
+// loop with < or >, and a part which starts with NaN is left to such a loop.
+// Parts give their index, indexes are compared in order.
+template <class Type>
+long reduce_arg(const Type * array, long length, bool is_max){
+	auto is_better = [array, is_max](long a, long b){ return is_max ? array[b] > array[a] : array[b] < array[a]; };
+	long part_amount = (length + REDUCE_PART_SIZE - 1) / REDUCE_PART_SIZE;
+	long thread_amount = reduce_thread_amount(length);
+	std::vector<long> indexes(part_amount);
+	std::vector<std::thread> threads;
+	long best = -1;
+
+	auto arg_part = [&](long first){
+		long end = std::min(length, first + REDUCE_PART_SIZE);
+		Type value = is_max ? reduce_part(array + first, end - first, array[first], [](Type a, Type b){ return b > a ? b : a; }) :
+			reduce_part(array + first, end - first, array[first], [](Type a, Type b){ return b < a ? b : a; });
+		long index = first;
+
+		for(long i = first; i < end; i++)
+			if(array[i] == value)
+				return i;
+		for(long i = first + 1; i < end; i++)
+			if(is_better(index, i))
+				index = i;
+		return index;
+	};
+	auto arg_parts = [&](long first_part, long last_part){
+		for(long i = first_part; i < last_part; i++)
+			indexes[i] = arg_part(i * REDUCE_PART_SIZE);
+	};
+
+	thread_amount = std::max(1L, std::min(thread_amount, part_amount));
+	for(long i = 1; i < thread_amount; i++)
+		threads.push_back(std::thread(arg_parts, part_amount * i / thread_amount, part_amount * (i + 1) / thread_amount));
+	arg_parts(0, part_amount / thread_amount);
+	for(auto & thread : threads)
+		thread.join();
+
+	for(long index : indexes)
+		if(best < 0 || is_better(best, index))
+			best = index;
+
+	return best;
+}
+
+template <class Type>
+long argmin(const Type * array, long length){
+	return reduce_arg(array, length, false);
+}
+
+template <class Type>
+long argmax(const Type * array, long length){
+	return reduce_arg(array, length, true);
+}
+
+// Same for contiguous containers and arrays, like std::vector or int[10].
+template <class Range>
+auto maxT(const Range & range){
+	return maxT(std::data(range), (long) std::size(range));
+}
+
+template <class Range>
+auto minT(const Range & range){
+	return minT(std::data(range), (long) std::size(range));
+}
+
+template <class Range>
+auto sum(const Range & range){
+	return sum(std::data(range), (long) std::size(range));
+}
+
+template <class Range>
+double average(const Range & range){
+	return average(std::data(range), (long) std::size(range));
+}
+
+template <class Range>
+long argmin(const Range & range){
+	return argmin(std::data(range), (long) std::size(range));
+}
+
+template <class Range>
+long argmax(const Range & range){
+	return argmax(std::data(range), (long) std::size(range));
+}
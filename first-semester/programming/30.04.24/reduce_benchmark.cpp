@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include "reduce.h"
+
+// Times scalar loops for max, min, argmin and sum one by one against the
+// reductions of reduce.h on int, float, double and byte arrays. Results have
+// to match, sums with one thread and with all threads have to be the same to
+// the bit.
+// Build: g++ -O2 -std=c++17 reduce_benchmark.cpp -o reduce_benchmark -pthread
+// Usage: ./reduce_benchmark [elements]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+template <class Type>
+void run_case(const char * name, long length){
+	std::vector<Type> array(length);
+	unsigned int seed = 83663;
+	double start;
+	bool is_valid = true;
+
+	for(auto & element : array){
+		seed = seed * 1103515245 + 12345;
+		element = (Type) ((int) (seed >> 8) % 1000000) / (Type) 7;
+	}
+
+	Type scalar_max = array[0], scalar_min = array[0];
+	long scalar_argmin = 0;
+	ReduceSum<Type> scalar_sum = 0;
+	double times[4][2];
+
+	start = get_seconds();
+	for(long i = 0; i < length; i++)
+		if(array[i] > scalar_max)
+			scalar_max = array[i];
+	times[0][0] = get_seconds() - start;
+	start = get_seconds();
+	for(long i = 0; i < length; i++)
+		if(array[i] < scalar_min)
+			scalar_min = array[i];
+	times[1][0] = get_seconds() - start;
+	start = get_seconds();
+	for(long i = 0; i < length; i++)
+		if(array[i] < array[scalar_argmin])
+			scalar_argmin = i;
+	times[2][0] = get_seconds() - start;
+	start = get_seconds();
+	for(long i = 0; i < length; i++)
+		scalar_sum += array[i];
+	times[3][0] = get_seconds() - start;
+
+	start = get_seconds();
+	Type max = maxT(array);
+	times[0][1] = get_seconds() - start;
+	start = get_seconds();
+	Type min = minT(array);
+	times[1][1] = get_seconds() - start;
+	start = get_seconds();
+	long index = argmin(array);
+	times[2][1] = get_seconds() - start;
+	start = get_seconds();
+	ReduceSum<Type> total = sum(array);
+	times[3][1] = get_seconds() - start;
+
+	ReduceSum<Type> one_thread_total = reduce_with_threads(array.data(), length, (ReduceSum<Type>) 0,
+		[](ReduceSum<Type> a, ReduceSum<Type> b){ return a + b; }, 1);
+
+	is_valid = max == scalar_max && min == scalar_min && index == scalar_argmin && total == one_thread_total;
+	// float sums are added in another order than the loop
+	if(std::is_integral<Type>::value)
+		is_valid = is_valid && total == scalar_sum;
+
+	const char * operations[4] = {"maxT", "minT", "argmin", "sum"};
+	for(int i = 0; i < 4; i++)
+		std::cout << name << " " << operations[i] << ": scalar loop " << times[i][0] * 1000 << " ms, reduce.h " << times[i][1] * 1000 << " ms\n";
+	std::cout << name << " sum " << total << " (loop " << scalar_sum << ") " << (is_valid ? "ok" : "INVALID") << "\n";
+};
+
+int main(int argc, char ** argv){
+	long length = argc > 1 ? atol(argv[1]) : 50000000;
+
+	run_case<int>("int", length);
+	run_case<float>("float", length);
+	run_case<double>("double", length);
+	run_case<unsigned char>("byte", length);
+};
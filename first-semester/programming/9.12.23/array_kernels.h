@@ -0,0 +1,219 @@
+#pragma once
+
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ARRAY_KERNELS_AVX2
+#endif
+
+// Array kernels of the lab for int, float and byte (unsigned char) arrays:
+// in-place reversal, counting and finding elements equal to a value and
+// counting them in every row of a matrix. Scalar versions are templates,
+// AVX2 versions reverse with permutes and shuffles and compare 32 bytes at a
+// time, turning the comparison into a bit mask for popcount or ctz. Calls
+// without a suffix select the AVX2 version when the CPU supports it. Floats
+// compare like ==, so NaN equals nothing and 0.0 equals -0.0.
+
+inline bool array_kernels_has_avx2(){
+#ifdef ARRAY_KERNELS_AVX2
+	static const bool has_avx2 = __builtin_cpu_supports("avx2");
+	return has_avx2;
+#else
+	return false;
+#endif
+};
+
+template <typename T>
+inline void array_reverse_scalar(T * array, long length){
+	for(long i = 0; i < length / 2; i++){
+		T tmp = array[i];
+		array[i] = array[length - 1 - i];
+		array[length - 1 - i] = tmp;
+	}
+};
+
+template <typename T>
+inline long array_count_equal_scalar(const T * array, long length, T value){
+	long count = 0;
+
+	for(long i = 0; i < length; i++)
+		count += array[i] == value;
+
+	return count;
+};
+
+// Index of the first element equal to value, -1 when there is none.
+template <typename T>
+inline long array_find_first_scalar(const T * array, long length, T value){
+	for(long i = 0; i < length; i++)
+		if(array[i] == value)
+			return i;
+
+	return -1;
+};
+
+#ifdef ARRAY_KERNELS_AVX2
+
+// Swaps blocks of 8 from both ends reversed with vpermd, the middle of less
+// than 16 elements is reversed by the scalar loop. T is int or float, the
+// middle is reversed through T so the array is never accessed as another type.
+template <typename T>
+__attribute__((target("avx2")))
+inline void array_reverse_avx2(T * array, long length){
+	static_assert(sizeof(T) == 4, "vpermd moves 32-bit elements");
+	const __m256i reversed = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	long i = 0;
+
+	for(; i + 16 <= length - i; i += 8){
+		__m256i front = _mm256_loadu_si256((const __m256i *)(array + i));
+		__m256i back = _mm256_loadu_si256((const __m256i *)(array + length - i - 8));
+		_mm256_storeu_si256((__m256i *)(array + i), _mm256_permutevar8x32_epi32(back, reversed));
+		_mm256_storeu_si256((__m256i *)(array + length - i - 8), _mm256_permutevar8x32_epi32(front, reversed));
+	}
+
+	array_reverse_scalar(array + i, length - 2 * i);
+};
+
+// Bytes are reversed inside 128-bit lanes with vpshufb, then lanes are swapped.
+__attribute__((target("avx2")))
+inline void array_reverse_avx2(unsigned char * array, long length){
+	const __m256i reversed = _mm256_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	long i = 0;
+
+	for(; i + 64 <= length - i; i += 32){
+		__m256i front = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(array + i)), reversed);
+		__m256i back = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(array + length - i - 32)), reversed);
+		_mm256_storeu_si256((__m256i *)(array + i), _mm256_permute2x128_si256(back, back, 1));
+		_mm256_storeu_si256((__m256i *)(array + length - i - 32), _mm256_permute2x128_si256(front, front, 1));
+	}
+
+	array_reverse_scalar(array + i, length - 2 * i);
+};
+
+// Bit i of the mask is set when element i of the 32 bytes at array equals
+// the value.
+__attribute__((target("avx2")))
+inline unsigned int array_equal_mask_avx2(const int * array, __m256i value){
+	return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *) array), value)));
+};
+
+__attribute__((target("avx2")))
+inline unsigned int array_equal_mask_avx2(const float * array, __m256 value){
+	return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(array), value, _CMP_EQ_OQ));
+};
+
+__attribute__((target("avx2")))
+inline unsigned int array_equal_mask_avx2(const unsigned char * array, __m256i value){
+	return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) array), value));
+};
+
+__attribute__((target("avx2")))
+inline __m256i array_broadcast_avx2(int value){
+	return _mm256_set1_epi32(value);
+};
+
+__attribute__((target("avx2")))
+inline __m256 array_broadcast_avx2(float value){
+	return _mm256_set1_ps(value);
+};
+
+__attribute__((target("avx2")))
+inline __m256i array_broadcast_avx2(unsigned char value){
+	return _mm256_set1_epi8((char) value);
+};
+
+// Four masks are counted per step so popcounts of separate loads overlap.
+template <typename T>
+__attribute__((target("avx2,popcnt")))
+inline long array_count_equal_avx2(const T * array, long length, T value){
+	const long step = 32 / sizeof(T);
+	auto needle = array_broadcast_avx2(value);
+	long count = 0, i = 0;
+
+	for(; i + 4 * step <= length; i += 4 * step)
+		count += __builtin_popcount(array_equal_mask_avx2(array + i, needle)) +
+			__builtin_popcount(array_equal_mask_avx2(array + i + step, needle)) +
+			__builtin_popcount(array_equal_mask_avx2(array + i + 2 * step, needle)) +
+			__builtin_popcount(array_equal_mask_avx2(array + i + 3 * step, needle));
+	for(; i + step <= length; i += step)
+		count += __builtin_popcount(array_equal_mask_avx2(array + i, needle));
+
+	return count + array_count_equal_scalar(array + i, length - i, value);
+};
+
+template <typename T>
+__attribute__((target("avx2")))
+inline long array_find_first_avx2(const T * array, long length, T value){
+	const long step = 32 / sizeof(T);
+	auto needle = array_broadcast_avx2(value);
+	long i = 0, index;
+
+	for(; i + step <= length; i += step){
+		unsigned int mask = array_equal_mask_avx2(array + i, needle);
+		if(mask != 0)
+			return i + __builtin_ctz(mask);
+	}
+
+	index = array_find_first_scalar(array + i, length - i, value);
+	return index < 0 ? -1 : i + index;
+};
+
+#endif
+
+inline void array_reverse(int * array, long length){
+#ifdef ARRAY_KERNELS_AVX2
+	if(array_kernels_has_avx2()){
+		array_reverse_avx2(array, length);
+		return;
+	}
+#endif
+	array_reverse_scalar(array, length);
+};
+
+inline void array_reverse(float * array, long length){
+#ifdef ARRAY_KERNELS_AVX2
+	if(array_kernels_has_avx2()){
+		array_reverse_avx2(array, length);
+		return;
+	}
+#endif
+	array_reverse_scalar(array, length);
+};
+
+inline void array_reverse(unsigned char * array, long length){
+#ifdef ARRAY_KERNELS_AVX2
+	if(array_kernels_has_avx2()){
+		array_reverse_avx2(array, length);
+		return;
+	}
+#endif
+	array_reverse_scalar(array, length);
+};
+
+// T is int, float or unsigned char.
+template <typename T>
+inline long array_count_equal(const T * array, long length, T value){
+#ifdef ARRAY_KERNELS_AVX2
+	if(array_kernels_has_avx2())
+		return array_count_equal_avx2(array, length, value);
+#endif
+	return array_count_equal_scalar(array, length, value);
+};
+
+template <typename T>
+inline long array_find_first(const T * array, long length, T value){
+#ifdef ARRAY_KERNELS_AVX2
+	if(array_kernels_has_avx2())
+		return array_find_first_avx2(array, length, value);
+#endif
+	return array_find_first_scalar(array, length, value);
+};
+
+// counts[i] is amount of elements equal to value in row i of a row-major
+// matrix.
+template <typename T>
+inline void array_count_equal_rows(const T * matrix, long rows, long columns, T value, long * counts){
+	for(long i = 0; i < rows; i++)
+		counts[i] = array_count_equal(matrix + i * columns, columns, value);
+};
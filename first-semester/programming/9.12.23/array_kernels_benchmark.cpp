@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <iostream>
+#include <vector>
+#include "array_kernels.h"
+
+// Checks every kernel against its scalar version for all lengths up to 300,
+// then times reverse, count-equal and find-first of both on big int, float
+// and byte arrays, and counting zeros in every row of a matrix.
+// Build: g++ -O2 array_kernels_benchmark.cpp -o array_kernels_benchmark
+// Usage: ./array_kernels_benchmark [elements]
+
+double get_seconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+};
+
+template <typename T>
+void fill_array(std::vector<T> & array, unsigned int seed){
+	for(auto & element : array){
+		seed = seed * 1103515245 + 12345;
+		element = (T) ((seed >> 16) % 7);
+	}
+};
+
+template <typename T>
+bool check_kernels(unsigned int seed){
+	bool is_valid = true;
+
+	for(long length = 0; length <= 300 && is_valid; length++){
+		std::vector<T> array(length), reversed;
+
+		fill_array(array, seed + length);
+		reversed = array;
+		array_reverse(reversed.data(), length);
+		for(long i = 0; i < length; i++)
+			is_valid = is_valid && reversed[i] == array[length - 1 - i];
+
+		for(T value : {(T) 0, (T) 3, (T) 9})
+			is_valid = is_valid && array_count_equal(array.data(), length, value) == array_count_equal_scalar(array.data(), length, value) &&
+				array_find_first(array.data(), length, value) == array_find_first_scalar(array.data(), length, value);
+	}
+
+	return is_valid;
+};
+
+template <typename T>
+void run_case(const char * name, long length){
+	std::vector<T> array(length);
+	double start, scalar_time, time;
+	long scalar_result, result;
+	bool is_valid;
+
+	fill_array(array, 83663);
+
+	start = get_seconds();
+	array_reverse_scalar(array.data(), length);
+	scalar_time = get_seconds() - start;
+	start = get_seconds();
+	array_reverse(array.data(), length);
+	time = get_seconds() - start;
+	std::cout << name << " reverse: scalar " << scalar_time * 1000 << " ms, kernel " << time * 1000 << " ms\n";
+
+	start = get_seconds();
+	scalar_result = array_count_equal_scalar(array.data(), length, (T) 0);
+	scalar_time = get_seconds() - start;
+	start = get_seconds();
+	result = array_count_equal(array.data(), length, (T) 0);
+	time = get_seconds() - start;
+	is_valid = result == scalar_result;
+	std::cout << name << " count equal: scalar " << scalar_time * 1000 << " ms, kernel " << time * 1000 << " ms\n";
+
+	// value only at the end, so both scan the whole array
+	array[length - 1] = (T) 100;
+	start = get_seconds();
+	scalar_result = array_find_first_scalar(array.data(), length, (T) 100);
+	scalar_time = get_seconds() - start;
+	start = get_seconds();
+	result = array_find_first(array.data(), length, (T) 100);
+	time = get_seconds() - start;
+	is_valid = is_valid && result == scalar_result && result == length - 1;
+	std::cout << name << " find first: scalar " << scalar_time * 1000 << " ms, kernel " << time * 1000 << " ms\n";
+
+	long rows = 1000, columns = length / rows;
+	std::vector<long> scalar_counts(rows), counts(rows);
+	start = get_seconds();
+	for(long i = 0; i < rows; i++)
+		scalar_counts[i] = array_count_equal_scalar(array.data() + i * columns, columns, (T) 0);
+	scalar_time = get_seconds() - start;
+	start = get_seconds();
+	array_count_equal_rows(array.data(), rows, columns, (T) 0, counts.data());
+	time = get_seconds() - start;
+	is_valid = is_valid && counts == scalar_counts;
+	std::cout << name << " count per row: scalar " << scalar_time * 1000 << " ms, kernel " << time * 1000 << " ms "
+		<< (is_valid ? "ok" : "INVALID") << "\n";
+};
+
+int main(int argc, char ** argv){
+	long length = argc > 1 ? atol(argv[1]) : 64000000;
+
+	std::cout << "avx2: " << (array_kernels_has_avx2() ? "yes" : "no") << ", elements: " << length << "\n"
+		<< (check_kernels<int>(1) && check_kernels<float>(2) && check_kernels<unsigned char>(3) ? "ok" : "INVALID") << "\n";
+
+	run_case<int>("int", length);
+	run_case<float>("float", length);
+	run_case<unsigned char>("byte", length);
+};
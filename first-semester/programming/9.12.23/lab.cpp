@@ -1,4 +1,5 @@
 #include <iostream>
+#include "array_kernels.h"
 
 void reverse_array(int * arr, int n);
 
@@ -30,27 +31,16 @@ int main(){
 	};
 
 
-	for(int i = 0; i < 5; i++){
-		int zero_count = 0;
-		for(int j = 0; j < 5; j++){
+	long zero_counts[5];
+	array_count_equal_rows(&a[0][0], 5, 5, 0, zero_counts);
 
-			if(a[i][j] == 0)
-				zero_count++;
-		}
-
-		std::cout << "Zero count " << zero_count << std::endl;
-
-	}
+	for(int i = 0; i < 5; i++)
+		std::cout << "Zero count " << zero_counts[i] << std::endl;
 
 	return 0;
 }
 
 void reverse_array(int * arr, int n){
-	int tmp;
-	for(int i = 0; i < n / 2; i++){
-		tmp = *(arr + i);
-		*(arr + i) = *(arr + n - 1 - i);
-		*(arr + n - 1 - i) = tmp;
-	}
+	array_reverse(arr, n);
 }
 
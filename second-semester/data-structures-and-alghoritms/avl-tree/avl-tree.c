@@ -21,370 +21,303 @@ struct AVLTreeNode *newNode(int value)
     struct AVLTreeNode *newNode = (struct AVLTreeNode *)malloc(sizeof(struct AVLTreeNode));
     newNode->leftChild = NULL;
     newNode->rightChild = NULL;
+    newNode->parent = NULL;
     newNode->value = value;
+    newNode->height = 0;
 
     return newNode;
 }
 
 void addNode(struct AVLTree *self, struct AVLTreeNode *newNode)
 {
+    newNode->leftChild = NULL;
+    newNode->rightChild = NULL;
+    newNode->parent = NULL;
+    newNode->height = 0;
+
     if (self->rootNode)
     {
-        addNodeRecursively(newNode, self->rootNode);
+        addNodeIteratively(newNode, self->rootNode);
     }
     else
     {
         self->rootNode = newNode;
     }
 
-    struct AVLTreeNode *inbalancedNode = NULL;
-    if (((inbalancedNode = self->_getInbalancedSubtreeRotationNode(newNode)) != NULL) && newNode->parent)
-    {
-        _rotateTree(self, inbalancedNode);
-    }
+    // only the path from the new leaf to the root can be out of balance
+    self->balance(self, newNode->parent);
 }
 
-void addNodeRecursively(struct AVLTreeNode *newNode, struct AVLTreeNode *avlTreeNode)
+void addNodeIteratively(struct AVLTreeNode *newNode, struct AVLTreeNode *avlTreeNode)
 {
-    if (newNode->value > avlTreeNode->value)
+    while (true)
     {
-        if (avlTreeNode->rightChild == NULL)
+        if (newNode->value > avlTreeNode->value)
         {
-            newNode->parent = avlTreeNode;
-            avlTreeNode->rightChild = newNode;
-            return;
-        }
-        else
-        {
-            addNodeRecursively(newNode, avlTreeNode->rightChild);
-        }
-    }
-    else
-    {
-        if (avlTreeNode->leftChild == NULL)
-        {
-            newNode->parent = avlTreeNode;
-            avlTreeNode->leftChild = newNode;
-            return;
+            if (avlTreeNode->rightChild == NULL)
+            {
+                newNode->parent = avlTreeNode;
+                avlTreeNode->rightChild = newNode;
+                return;
+            }
+            avlTreeNode = avlTreeNode->rightChild;
         }
         else
         {
-            addNodeRecursively(newNode, avlTreeNode->leftChild);
+            if (avlTreeNode->leftChild == NULL)
+            {
+                newNode->parent = avlTreeNode;
+                avlTreeNode->leftChild = newNode;
+                return;
+            }
+            avlTreeNode = avlTreeNode->leftChild;
         }
     }
-    return;
 }
 
 void removeNode(struct AVLTree *self, int value)
 {
-    removeNodeByValueRecursively(self, value, self->rootNode);
+    struct AVLTreeNode *retraceNode = removeNodeByValueIteratively(self, value, self->rootNode);
 
-    balance(self, self->rootNode);
+    self->balance(self, retraceNode);
 }
 
-void removeNodeByValueRecursively(struct AVLTree *self, int value, struct AVLTreeNode *avlTreeNode)
+// Unlinks and frees the node with the given value. Returns the lowest node
+// whose subtree changed, balancing has to start from it. Returns NULL when
+// the value is not in the tree or the tree became empty.
+struct AVLTreeNode *removeNodeByValueIteratively(struct AVLTree *self, int value, struct AVLTreeNode *avlTreeNode)
 {
-    if (value > avlTreeNode->value)
+    while (avlTreeNode != NULL && avlTreeNode->value != value)
     {
-        removeNodeByValueRecursively(self, value, avlTreeNode->rightChild);
+        avlTreeNode = value > avlTreeNode->value ? avlTreeNode->rightChild : avlTreeNode->leftChild;
     }
-    else if (value < avlTreeNode->value)
+
+    if (avlTreeNode == NULL)
+        return NULL;
+
+    struct AVLTreeNode *leftChild = avlTreeNode->leftChild;
+    struct AVLTreeNode *rightChild = avlTreeNode->rightChild;
+    struct AVLTreeNode *parent = avlTreeNode->parent;
+    struct AVLTreeNode *retraceNode = NULL;
+
+    if (leftChild == NULL || rightChild == NULL)
     {
-        removeNodeByValueRecursively(self, value, avlTreeNode->leftChild);
+        struct AVLTreeNode *child = leftChild != NULL ? leftChild : rightChild;
+
+        _replaceChild(self, parent, avlTreeNode, child);
+        retraceNode = parent;
     }
-    else if (value == avlTreeNode->value)
+    else
     {
-        struct AVLTreeNode *leftChild = avlTreeNode->leftChild;
-        struct AVLTreeNode *rightChild = avlTreeNode->rightChild;
-        struct AVLTreeNode *parent = avlTreeNode->parent;
-
-        if (parent)
+        // replace the node with its in-order successor
+        struct AVLTreeNode *successor = rightChild;
+        while (successor->leftChild != NULL)
         {
-            if (parent->leftChild->value == value)
-            {
-                free(parent->leftChild);
-                parent->leftChild = NULL;
-            }
+            successor = successor->leftChild;
+        }
 
-            if (parent->rightChild->value == value)
-            {
-                free(parent->rightChild);
-                parent->rightChild = NULL;
-            }
+        if (successor == rightChild)
+        {
+            retraceNode = successor;
         }
         else
         {
-            struct AVLTreeNode *n = avlTreeNode->leftChild != NULL ? avlTreeNode->leftChild : avlTreeNode->rightChild;
-            while (n->rightChild != NULL)
-            {
-                n = n->rightChild;
-            }
+            retraceNode = successor->parent;
+            retraceNode->leftChild = successor->rightChild;
+            if (successor->rightChild)
+                successor->rightChild->parent = retraceNode;
 
-            parent = n;
-            n->parent->rightChild = NULL;
-            n->parent = NULL;
-
-            if (rightChild == n)
-            {
-                rightChild = NULL;
-            }
-
-            if (leftChild == n)
-            {
-                leftChild = NULL;
-            }
-            self->rootNode = parent;
+            successor->rightChild = rightChild;
+            rightChild->parent = successor;
         }
 
-        if (rightChild)
-        {
-            addNodeRecursively(rightChild, parent);
-        }
-        if (leftChild)
-        {
-            addNodeRecursively(leftChild, parent);
-        }
+        successor->leftChild = leftChild;
+        leftChild->parent = successor;
+        successor->height = avlTreeNode->height;
+        _replaceChild(self, parent, avlTreeNode, successor);
     }
-    return;
+
+    free(avlTreeNode);
+
+    return retraceNode;
+}
+
+// Returns the taller child of the node when the node is out of balance,
+// rotating around that child restores the balance. Returns NULL otherwise.
+struct AVLTreeNode *_getInbalancedSubtreeRotationNode(struct AVLTreeNode *node)
+{
+    int maxDepthLeftSubtree = _getTreeDepth(node->leftChild);
+    int maxDepthRightSubtree = _getTreeDepth(node->rightChild);
+
+    if (abs(maxDepthLeftSubtree - maxDepthRightSubtree) <= 1)
+        return NULL;
+
+    return maxDepthLeftSubtree > maxDepthRightSubtree ? node->leftChild : node->rightChild;
 }
 
-struct AVLTreeNode *_getInbalancedSubtreeRotationNode(struct AVLTreeNode *newNode)
+int _getTreeDepth(struct AVLTreeNode *node)
 {
+    return node ? node->height : -1;
+}
 
-    int maxDepthLeftSubtree = 0;
-    int maxDepthRightSubtree = 0;
-    bool isBallanced = true;
+void _updateTreeDepth(struct AVLTreeNode *node)
+{
+    int heightLeft = _getTreeDepth(node->leftChild);
+    int heightRight = _getTreeDepth(node->rightChild);
 
-    struct AVLTreeNode *node = newNode;
+    node->height = (heightLeft > heightRight ? heightLeft : heightRight) + 1;
+}
 
-    while (node && isBallanced)
+// Walks from the node up to the root through parent pointers, updating
+// heights and rotating out of balance subtrees. Stops as soon as a subtree
+// keeps its height, since nothing above it can change.
+void balance(struct AVLTree *self, struct AVLTreeNode *node)
+{
+    while (node != NULL)
     {
-        maxDepthLeftSubtree = _getTreeDepthRecursively(node->leftChild);
-        maxDepthRightSubtree = _getTreeDepthRecursively(node->rightChild);
+        int oldHeight = node->height;
+        struct AVLTreeNode *rotationNode = NULL;
 
-        isBallanced = abs(maxDepthLeftSubtree - maxDepthRightSubtree) <= 1;
+        _updateTreeDepth(node);
 
-        if (isBallanced == false)
+        if ((rotationNode = self->_getInbalancedSubtreeRotationNode(node)) != NULL)
         {
-            if (maxDepthLeftSubtree - maxDepthRightSubtree > 0)
-            {
-                node = node->leftChild;
-            }
-            else
-            {
-                node = node->rightChild;
-            }
-            break;
+            node = _rotateTree(self, rotationNode);
         }
 
-        maxDepthLeftSubtree = 0;
-        maxDepthRightSubtree = 0;
+        if (node->height == oldHeight)
+            break;
 
         node = node->parent;
     }
-
-    if (isBallanced)
-        node = NULL;
-
-    return node;
 }
 
-int _getTreeDepthRecursively(struct AVLTreeNode *node)
+// Rotates the parent of the rotation node, which is the taller child of an
+// out of balance node. Returns the new root of the rotated subtree.
+struct AVLTreeNode *_rotateTree(struct AVLTree *self, struct AVLTreeNode *rotationNode)
 {
-    if (!node)
-        return -1;
+    struct AVLTreeNode *inbalancedNode = rotationNode->parent;
+
+    if (rotationNode == inbalancedNode->leftChild)
+    {
+        if (_getTreeDepth(rotationNode->leftChild) < _getTreeDepth(rotationNode->rightChild))
+        {
+            // double right rotation
+            _rotateLeft(self, rotationNode);
+        }
 
-    int heightLeft = _getTreeDepthRecursively(node->leftChild);
-    int heightRight = _getTreeDepthRecursively(node->rightChild);
+        // right rotation
+        return _rotateRight(self, inbalancedNode);
+    }
+    else
+    {
+        if (_getTreeDepth(rotationNode->rightChild) < _getTreeDepth(rotationNode->leftChild))
+        {
+            // double left rotation
+            _rotateRight(self, rotationNode);
+        }
 
-    return (heightLeft > heightRight ? heightLeft : heightRight) + 1;
+        // left rotation
+        return _rotateLeft(self, inbalancedNode);
+    }
 }
 
-void balance(struct AVLTree *self, struct AVLTreeNode *node)
+struct AVLTreeNode *_rotateLeft(struct AVLTree *self, struct AVLTreeNode *node)
 {
-    if (node == NULL)
-        return;
+    struct AVLTreeNode *newParent = node->rightChild;
 
-    struct AVLTreeNode *inbalancedNode = NULL;
-    if (((inbalancedNode = self->_getInbalancedSubtreeRotationNode(node)) != NULL) && node->parent)
-    {
-        _rotateTree(self, inbalancedNode);
-    }
+    node->rightChild = newParent->leftChild;
+    if (newParent->leftChild)
+        newParent->leftChild->parent = node;
+
+    _replaceChild(self, node->parent, node, newParent);
+    newParent->leftChild = node;
+    node->parent = newParent;
 
-    balance(self, node->leftChild);
-    balance(self, node->rightChild);
+    _updateTreeDepth(node);
+    _updateTreeDepth(newParent);
+
+    return newParent;
 }
 
-void _rotateTree(struct AVLTree *self, struct AVLTreeNode *rotationNode)
+struct AVLTreeNode *_rotateRight(struct AVLTree *self, struct AVLTreeNode *node)
 {
-    struct AVLTreeNode *inbalancedNode = rotationNode->parent;
-    struct AVLTreeNode *newParent = inbalancedNode->parent;
-    struct AVLTreeNode *temp = NULL;
-    int leftTreeDepth = 0;
-    int rightTreeDepth = 0;
+    struct AVLTreeNode *newParent = node->leftChild;
 
-    leftTreeDepth = _getTreeDepthRecursively(inbalancedNode->leftChild);
-    rightTreeDepth = _getTreeDepthRecursively(inbalancedNode->rightChild);
+    node->leftChild = newParent->rightChild;
+    if (newParent->rightChild)
+        newParent->rightChild->parent = node;
 
-    if ((leftTreeDepth - rightTreeDepth) > 0)
-    {
+    _replaceChild(self, node->parent, node, newParent);
+    newParent->rightChild = node;
+    node->parent = newParent;
 
-        if (rotationNode->rightChild != NULL && rotationNode->leftChild == NULL)
-        {
+    _updateTreeDepth(node);
+    _updateTreeDepth(newParent);
 
-            // double right rotation
-            rotationNode = rotationNode->rightChild;
-            rotationNode->leftChild = rotationNode->parent;
-            rotationNode->parent->rightChild = NULL;
-
-            if (inbalancedNode == inbalancedNode->parent->leftChild)
-            {
-                inbalancedNode->parent->leftChild = rotationNode;
-                rotationNode->rightChild = rotationNode->parent;
-                rotationNode->rightChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else
-            {
-                inbalancedNode->parent->rightChild = rotationNode;
-                rotationNode->rightChild = rotationNode->parent;
-                rotationNode->rightChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            inbalancedNode->parent = rotationNode;
-            rotationNode->rightChild = inbalancedNode;
-            inbalancedNode->leftChild = NULL;
-        }
-        else
-        {
-            // right rotation
-            if (rotationNode->rightChild)
-            {
-                temp = rotationNode->rightChild;
-                temp->parent = NULL;
-            }
-
-            if (inbalancedNode->parent != NULL && inbalancedNode == inbalancedNode->parent->leftChild)
-            {
-                inbalancedNode->parent->leftChild = rotationNode;
-                rotationNode->rightChild = rotationNode->parent;
-                rotationNode->rightChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else if (inbalancedNode->parent != NULL && inbalancedNode == inbalancedNode->parent->rightChild)
-            {
-                inbalancedNode->parent->rightChild = rotationNode;
-                rotationNode->rightChild = rotationNode->parent;
-                rotationNode->rightChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else
-            {
-                rotationNode->rightChild = rotationNode->parent;
-                rotationNode->rightChild->parent = rotationNode;
-                rotationNode->parent = NULL;
-                self->rootNode = rotationNode;
-            }
-            inbalancedNode->parent = rotationNode;
-            inbalancedNode->leftChild = NULL;
-        }
+    return newParent;
+}
 
-        if (temp != NULL)
-        {
-            addNode(self, temp);
-        }
+void _replaceChild(struct AVLTree *self, struct AVLTreeNode *parent, struct AVLTreeNode *oldChild, struct AVLTreeNode *newChild)
+{
+    if (parent == NULL)
+    {
+        self->rootNode = newChild;
+    }
+    else if (parent->leftChild == oldChild)
+    {
+        parent->leftChild = newChild;
     }
     else
     {
-        if (rotationNode->rightChild == NULL && rotationNode->leftChild != NULL)
-        {
-
-            // double left rotation
-            rotationNode = rotationNode->leftChild;
-            rotationNode->rightChild = rotationNode->parent;
-            rotationNode->parent->leftChild = NULL;
-
-            if (inbalancedNode == inbalancedNode->parent->leftChild)
-            {
-                inbalancedNode->parent->leftChild = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else
-            {
-                inbalancedNode->parent->rightChild = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            inbalancedNode->parent = rotationNode;
-            rotationNode->leftChild = inbalancedNode;
-            inbalancedNode->rightChild = NULL;
-        }
-        else
-        {
-            if (rotationNode->leftChild)
-            {
-                temp = rotationNode->leftChild;
-                temp->parent = NULL;
-            }
-
-            // left rotation
-            if (inbalancedNode->parent != NULL && inbalancedNode == inbalancedNode->parent->leftChild)
-            {
-                inbalancedNode->parent->leftChild = rotationNode;
-                rotationNode->leftChild = rotationNode->parent;
-                rotationNode->leftChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else if (inbalancedNode->parent != NULL && inbalancedNode == inbalancedNode->parent->rightChild)
-            {
-                inbalancedNode->parent->rightChild = rotationNode;
-                rotationNode->leftChild = rotationNode->parent;
-                rotationNode->leftChild->parent = rotationNode;
-                rotationNode->parent = newParent;
-            }
-            else
-            {
-                rotationNode->leftChild = rotationNode->parent;
-                rotationNode->leftChild->parent = rotationNode;
-                rotationNode->parent = NULL;
-                self->rootNode = rotationNode;
-            }
-            inbalancedNode->parent = rotationNode;
-            inbalancedNode->rightChild = NULL;
-        }
-
-        if (temp != NULL)
-        {
-            addNode(self, temp);
-        }
+        parent->rightChild = newChild;
     }
+
+    if (newChild)
+        newChild->parent = parent;
 }
 
 void printTree(struct AVLTree *self)
 {
-
-    printf("Root node value: %d\n", self->rootNode->value);
     if (self->rootNode)
     {
-        printTreeRecursively(self->rootNode);
+        printf("Root node value: %d\n", self->rootNode->value);
+        printTreeIteratively(self->rootNode);
     }
 }
 
-void printTreeRecursively(struct AVLTreeNode *node)
+// Pre-order walk which climbs back through parent pointers instead of
+// keeping a stack.
+void printTreeIteratively(struct AVLTreeNode *node)
 {
-    printf("value: %d", node->value);
-    if (node->leftChild)
-        printf(", leftChildValue: %d", node->leftChild->value);
-    if (node->rightChild)
-        printf(", rightChildValue: %d", node->rightChild->value);
-    printf("\n");
-
-    if (node->leftChild)
-    {
-        printTreeRecursively(node->leftChild);
-    }
+    struct AVLTreeNode *subtreeParent = node->parent;
 
-    if (node->rightChild)
+    while (node != NULL)
     {
-        printTreeRecursively(node->rightChild);
+        printf("value: %d", node->value);
+        if (node->leftChild)
+            printf(", leftChildValue: %d", node->leftChild->value);
+        if (node->rightChild)
+            printf(", rightChildValue: %d", node->rightChild->value);
+        printf("\n");
+
+        if (node->leftChild)
+        {
+            node = node->leftChild;
+        }
+        else if (node->rightChild)
+        {
+            node = node->rightChild;
+        }
+        else
+        {
+            // climb until we leave a left subtree whose parent has a right child
+            while (node->parent != subtreeParent && (node == node->parent->rightChild || node->parent->rightChild == NULL))
+            {
+                node = node->parent;
+            }
+
+            node = node->parent != subtreeParent ? node->parent->rightChild : NULL;
+        }
     }
 }
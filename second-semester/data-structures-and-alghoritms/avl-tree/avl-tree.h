@@ -6,6 +6,7 @@ struct AVLTreeNode
     struct AVLTreeNode *rightChild;
     struct AVLTreeNode *parent;
     int value;
+    int height;
 };
 
 struct AVLTree
@@ -14,7 +15,7 @@ struct AVLTree
     void (*addNode)(struct AVLTree *self, struct AVLTreeNode *node);
     void (*removeNode)(struct AVLTree *self, int value);
     void (*printTree)(struct AVLTree *self);
-    struct AVLTreeNode *(*_getInbalancedSubtreeRotationNode)(struct AVLTreeNode *newNode);
+    struct AVLTreeNode *(*_getInbalancedSubtreeRotationNode)(struct AVLTreeNode *node);
     void (*balance)(struct AVLTree *self, struct AVLTreeNode *node);
 };
 
@@ -22,11 +23,15 @@ struct AVLTree *getAVLTree();
 void addNode(struct AVLTree *self, struct AVLTreeNode *newNode);
 struct AVLTreeNode *newNode(int value);
 void removeNode(struct AVLTree *self, int value);
-struct AVLTreeNode *_getInbalancedSubtreeRotationNode(struct AVLTreeNode *newNode);
-void _rotateTree(struct AVLTree *self, struct AVLTreeNode *node);
+struct AVLTreeNode *_getInbalancedSubtreeRotationNode(struct AVLTreeNode *node);
+struct AVLTreeNode *_rotateTree(struct AVLTree *self, struct AVLTreeNode *rotationNode);
+struct AVLTreeNode *_rotateLeft(struct AVLTree *self, struct AVLTreeNode *node);
+struct AVLTreeNode *_rotateRight(struct AVLTree *self, struct AVLTreeNode *node);
+void _replaceChild(struct AVLTree *self, struct AVLTreeNode *parent, struct AVLTreeNode *oldChild, struct AVLTreeNode *newChild);
 void balance(struct AVLTree *self, struct AVLTreeNode *node);
-void addNodeRecursively(struct AVLTreeNode *newNode, struct AVLTreeNode *avlTreeNode);
-void removeNodeByValueRecursively(struct AVLTree *self, int value, struct AVLTreeNode *avlTreeNode);
+void addNodeIteratively(struct AVLTreeNode *newNode, struct AVLTreeNode *avlTreeNode);
+struct AVLTreeNode *removeNodeByValueIteratively(struct AVLTree *self, int value, struct AVLTreeNode *avlTreeNode);
 void printTree(struct AVLTree *self);
-int _getTreeDepthRecursively(struct AVLTreeNode *node);
-void printTreeRecursively(struct AVLTreeNode *node);
+int _getTreeDepth(struct AVLTreeNode *node);
+void _updateTreeDepth(struct AVLTreeNode *node);
+void printTreeIteratively(struct AVLTreeNode *node);
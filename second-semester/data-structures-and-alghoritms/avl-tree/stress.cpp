@@ -0,0 +1,423 @@
+extern "C"
+{
+#include "./avl-tree.h"
+}
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <pthread.h>
+#include <random>
+#include <set>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+// Stress and performance harness for AVLTree.
+//
+// Every scenario is a fixed sequence of insert/remove operations which is
+// replayed against AVLTree and std::set<int>. The whole tree is validated (BST
+// order, parent pointers, height balance and the same contents as std::set)
+// after every operation for up to 1000 nodes, for larger runs after every
+// nodes / 100 operations and at the end. Validation is not timed.
+// Each scenario runs in a forked child, so a crash inside the tree is reported
+// as a failed scenario instead of stopping the whole run. Inside the child the
+// scenario runs on a thread with a 64 KiB stack, the same budget as a small
+// worker thread or fiber, so any deep recursion in the tree shows up as a crash.
+//
+// Build: gcc -O2 -c avl-tree.c && g++ -O2 stress.cpp avl-tree.o -o stress -pthread
+// Usage: ./stress [nodes] [seed] [timeout seconds per scenario]
+
+struct Operation
+{
+    bool isInsert;
+    int value;
+};
+
+struct Scenario
+{
+    const char *name;
+    std::vector<Operation> operations;
+};
+
+struct Latencies
+{
+    std::vector<long long> insert;
+    std::vector<long long> remove;
+};
+
+static long long nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static long long percentile(std::vector<long long> &samples, double p)
+{
+    if (samples.empty())
+        return 0;
+
+    size_t index = (size_t)(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static std::vector<int> distinctValues(int count, std::mt19937 &rng)
+{
+    std::vector<int> values(count);
+    for (int i = 0; i < count; i++)
+        values[i] = i * 2;
+    std::shuffle(values.begin(), values.end(), rng);
+    return values;
+}
+
+static std::vector<Scenario> getScenarios(int count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<Scenario> scenarios;
+    std::vector<int> values;
+
+    // random inserts, then every value removed in another random order
+    values = distinctValues(count, rng);
+    scenarios.push_back({"random", {}});
+    for (int value : values)
+        scenarios.back().operations.push_back({true, value});
+    std::shuffle(values.begin(), values.end(), rng);
+    for (int value : values)
+        scenarios.back().operations.push_back({false, value});
+
+    // ascending inserts, then ascending removes
+    scenarios.push_back({"sorted", {}});
+    for (int i = 0; i < count; i++)
+        scenarios.back().operations.push_back({true, i});
+    for (int i = 0; i < count; i++)
+        scenarios.back().operations.push_back({false, i});
+
+    // descending inserts, then descending removes
+    scenarios.push_back({"reverse-sorted", {}});
+    for (int i = count - 1; i >= 0; i--)
+        scenarios.back().operations.push_back({true, i});
+    for (int i = count - 1; i >= 0; i--)
+        scenarios.back().operations.push_back({false, i});
+
+    // 0, n-1, 1, n-2, ... hits the double rotations on both sides
+    scenarios.push_back({"zigzag", {}});
+    for (int low = 0, high = count - 1; low <= high; low++, high--)
+    {
+        scenarios.back().operations.push_back({true, low});
+        if (low != high)
+            scenarios.back().operations.push_back({true, high});
+    }
+    for (int i = count / 2; i < count; i++)
+        scenarios.back().operations.push_back({false, i});
+
+    // random inserts, 90% of the values removed, interleaved with new inserts
+    values = distinctValues(count, rng);
+    scenarios.push_back({"heavy-delete", {}});
+    for (int value : values)
+        scenarios.back().operations.push_back({true, value});
+    std::shuffle(values.begin(), values.end(), rng);
+    for (int i = 0; i < count * 9 / 10; i++)
+    {
+        scenarios.back().operations.push_back({false, values[i]});
+        if (i % 4 == 0)
+            scenarios.back().operations.push_back({true, values[i] + 1});
+    }
+
+    // random mix of inserts and removes of present values
+    scenarios.push_back({"mixed", {}});
+    {
+        std::vector<int> present;
+        std::uniform_int_distribution<int> coin(0, 2);
+        // 64-bit, so big counts do not overflow; next * 7919 % range is distinct
+        // for next below range when 7919, a prime, does not divide range
+        long long next = 0, range = std::min(count * 8LL, 2147483647LL);
+        if (range % 7919 == 0)
+            range--;
+        for (int i = 0; i < count * 2; i++)
+        {
+            if (present.empty() || coin(rng) != 0)
+            {
+                int value = (int)(next++ * 7919 % range);
+                present.push_back(value);
+                scenarios.back().operations.push_back({true, value});
+            }
+            else
+            {
+                size_t index = rng() % present.size();
+                scenarios.back().operations.push_back({false, present[index]});
+                present[index] = present.back();
+                present.pop_back();
+            }
+        }
+    }
+
+    return scenarios;
+}
+
+// Returns an empty string when the tree is valid, otherwise a description of
+// the first violated invariant.
+static std::string validate(struct AVLTree *avlTree, const std::set<int> &expected)
+{
+    char message[160];
+    struct AVLTreeNode *rootNode = avlTree->rootNode;
+
+    if (rootNode == NULL)
+        return expected.empty() ? "" : "tree is empty, expected values are missing";
+
+    if (rootNode->parent != NULL)
+        return "root node has a parent";
+
+    // iterative post-order, heights are kept next to the nodes on the stack
+    std::vector<std::pair<struct AVLTreeNode *, int>> stack;
+    std::vector<int> heights;
+    std::vector<int> inOrder;
+    size_t nodeCount = 0;
+
+    stack.push_back({rootNode, 0});
+    while (!stack.empty())
+    {
+        struct AVLTreeNode *node = stack.back().first;
+        int state = stack.back().second;
+
+        if (state == 0)
+        {
+            stack.back().second = 1;
+            if (node->leftChild)
+            {
+                if (node->leftChild->parent != node)
+                {
+                    snprintf(message, sizeof(message), "node %d: left child %d has a wrong parent", node->value, node->leftChild->value);
+                    return message;
+                }
+                stack.push_back({node->leftChild, 0});
+            }
+        }
+        else if (state == 1)
+        {
+            stack.back().second = 2;
+            inOrder.push_back(node->value);
+            if (node->rightChild)
+            {
+                if (node->rightChild->parent != node)
+                {
+                    snprintf(message, sizeof(message), "node %d: right child %d has a wrong parent", node->value, node->rightChild->value);
+                    return message;
+                }
+                stack.push_back({node->rightChild, 0});
+            }
+        }
+        else
+        {
+            int heightRight = node->rightChild ? heights.back() : -1;
+            if (node->rightChild)
+                heights.pop_back();
+            int heightLeft = node->leftChild ? heights.back() : -1;
+            if (node->leftChild)
+                heights.pop_back();
+
+            if (abs(heightLeft - heightRight) > 1)
+            {
+                snprintf(message, sizeof(message), "node %d is out of balance (left height %d, right height %d)", node->value, heightLeft, heightRight);
+                return message;
+            }
+
+            heights.push_back((heightLeft > heightRight ? heightLeft : heightRight) + 1);
+            stack.pop_back();
+            nodeCount++;
+        }
+
+        if (stack.size() + nodeCount > expected.size() * 2 + 16)
+            return "tree contains a cycle";
+    }
+
+    for (size_t i = 1; i < inOrder.size(); i++)
+    {
+        if (inOrder[i - 1] >= inOrder[i])
+        {
+            snprintf(message, sizeof(message), "BST order violated: %d is followed by %d", inOrder[i - 1], inOrder[i]);
+            return message;
+        }
+    }
+
+    if (inOrder.size() != expected.size() || !std::equal(inOrder.begin(), inOrder.end(), expected.begin()))
+    {
+        snprintf(message, sizeof(message), "tree holds %zu values, expected %zu", inOrder.size(), expected.size());
+        return message;
+    }
+
+    return "";
+}
+
+static bool runScenario(const Scenario &scenario, size_t validateEvery)
+{
+    struct AVLTree *avlTree = getAVLTree();
+    std::set<int> expected;
+    Latencies avlLatencies;
+    std::string error;
+    size_t step = 0;
+
+    for (const Operation &operation : scenario.operations)
+    {
+        long long start = nowNs();
+        if (operation.isInsert)
+        {
+            avlTree->addNode(avlTree, newNode(operation.value));
+            avlLatencies.insert.push_back(nowNs() - start);
+            expected.insert(operation.value);
+        }
+        else
+        {
+            avlTree->removeNode(avlTree, operation.value);
+            avlLatencies.remove.push_back(nowNs() - start);
+            expected.erase(operation.value);
+        }
+
+        if (step % validateEvery == 0 || step + 1 == scenario.operations.size())
+        {
+            error = validate(avlTree, expected);
+            if (!error.empty())
+                break;
+        }
+        step++;
+    }
+
+    // replay the same sequence against std::set for reference numbers
+    std::set<int> reference;
+    Latencies setLatencies;
+    for (const Operation &operation : scenario.operations)
+    {
+        long long start = nowNs();
+        if (operation.isInsert)
+        {
+            reference.insert(operation.value);
+            setLatencies.insert.push_back(nowNs() - start);
+        }
+        else
+        {
+            reference.erase(operation.value);
+            setLatencies.remove.push_back(nowNs() - start);
+        }
+    }
+
+    printf("%-15s %8zu  %-4s  %6lld %6lld  %6lld %6lld  %6lld %6lld  %6lld %6lld\n",
+           scenario.name, scenario.operations.size(), error.empty() ? "ok" : "FAIL",
+           percentile(avlLatencies.insert, 0.5), percentile(avlLatencies.insert, 0.99),
+           percentile(avlLatencies.remove, 0.5), percentile(avlLatencies.remove, 0.99),
+           percentile(setLatencies.insert, 0.5), percentile(setLatencies.insert, 0.99),
+           percentile(setLatencies.remove, 0.5), percentile(setLatencies.remove, 0.99));
+
+    if (!error.empty())
+    {
+        const Operation &operation = scenario.operations[step];
+        printf("    by operation %zu (%s %d): %s\n", step, operation.isInsert ? "insert" : "remove", operation.value, error.c_str());
+    }
+
+    return error.empty();
+}
+
+struct ScenarioRun
+{
+    const Scenario *scenario;
+    size_t validateEvery;
+};
+
+static void *runScenarioThread(void *argument)
+{
+    struct ScenarioRun *run = (struct ScenarioRun *)argument;
+    return (void *)(long)runScenario(*run->scenario, run->validateEvery);
+}
+
+static bool runScenarioOnSmallStack(const Scenario &scenario, size_t validateEvery)
+{
+    struct ScenarioRun run = {&scenario, validateEvery};
+    pthread_attr_t attributes;
+    pthread_t thread;
+    void *isValid = NULL;
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, 64 * 1024);
+    pthread_create(&thread, &attributes, runScenarioThread, &run);
+    pthread_join(thread, &isValid);
+    pthread_attr_destroy(&attributes);
+
+    return isValid != NULL;
+}
+
+// Heap bytes per stored value, measured through malloc statistics so that
+// allocator overhead is included for both containers.
+static void printMemoryPerNode(int count)
+{
+    size_t before = mallinfo2().uordblks;
+    struct AVLTree *avlTree = getAVLTree();
+    for (int i = 0; i < count; i++)
+        avlTree->addNode(avlTree, newNode(i));
+    size_t avlBytes = mallinfo2().uordblks - before;
+
+    before = mallinfo2().uordblks;
+    std::set<int> *reference = new std::set<int>();
+    for (int i = 0; i < count; i++)
+        reference->insert(i);
+    size_t setBytes = mallinfo2().uordblks - before;
+
+    printf("memory per node: AVLTree %.1f bytes (sizeof node %zu), std::set %.1f bytes\n",
+           (double)avlBytes / count, sizeof(struct AVLTreeNode), (double)setBytes / count);
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? atoi(argv[1]) : 1000;
+    unsigned seed = argc > 2 ? (unsigned)atoi(argv[2]) : 83663;
+    unsigned timeout = argc > 3 ? (unsigned)atoi(argv[3]) : 30;
+    size_t validateEvery = count > 1000 ? count / 100 : 1;
+    int failed = 0;
+
+    printf("nodes: %d, seed: %u, latencies in ns\n", count, seed);
+    printf("%-15s %8s  %-4s  %13s  %13s  %13s  %13s\n", "scenario", "ops", "", "avl insert", "avl remove", "set insert", "set remove");
+    printf("%-15s %8s  %-4s  %6s %6s  %6s %6s  %6s %6s  %6s %6s\n", "", "", "", "p50", "p99", "p50", "p99", "p50", "p99", "p50", "p99");
+
+    for (const Scenario &scenario : getScenarios(count, seed))
+    {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            alarm(timeout);
+            bool isValid = runScenarioOnSmallStack(scenario, validateEvery);
+            fflush(stdout);
+            _exit(isValid ? 0 : 1);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+            printf("%-15s %8zu  TIMEOUT (%us)\n", scenario.name, scenario.operations.size(), timeout);
+        else if (WIFSIGNALED(status))
+            printf("%-15s %8zu  CRASHED (%s)\n", scenario.name, scenario.operations.size(), strsignal(WTERMSIG(status)));
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            failed++;
+    }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        alarm(timeout);
+        printMemoryPerNode(count);
+        fflush(stdout);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+        printf("memory per node: TIMEOUT (%us)\n", timeout);
+    else if (WIFSIGNALED(status))
+        printf("memory per node: CRASHED (%s)\n", strsignal(WTERMSIG(status)));
+
+    return failed > 0;
+}
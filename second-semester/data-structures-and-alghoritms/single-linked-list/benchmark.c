@@ -0,0 +1,411 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "./sll.h"
+#include "./utils.h"
+
+// Benchmark for singly linked list.
+// Times building a list with addNode and appendMany, then compares quickSort
+// and mergeSort on the same lists and checks that every result is ordered by
+// key and still holds every node. Last compares sortList and a full scan
+// (deleteNode of a missing value after sorting) between node and unrolled
+// lists, bulk deleteNode with and without the hash index, the scalar
+// sumString kernel against the one selected for the CPU, lexicographic
+// radix sort of node and unrolled lists, and keeping a list sorted between
+// batches of addNode with sortList against the skip list of getSortedSLL.
+// Loading a list from a text file is timed with a copy of every line read
+// with fgets against loadSLLFromFile.
+//
+// Build: gcc -O2 benchmark.c sll.c sll-index.c sll-file.c unrolled-sll.c radix-sort.c skip-list.c utils.c -o benchmark -pthread
+// Usage: ./benchmark [nodes] [adversarial nodes]
+
+double getSeconds()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Builds a list over the values without going through addNode, so building
+// the list does not dominate the benchmark.
+struct SLLNode *buildList(char **values, int length)
+{
+    struct SLLNode *nodes = (struct SLLNode *)malloc(sizeof(struct SLLNode) * length);
+
+    for (int i = 0; i < length; i++)
+    {
+        nodes[i].value = values[i];
+        nodes[i].valueLength = strlen(values[i]);
+        nodes[i].key = sumString(values[i]);
+        nodes[i].nextNode = i + 1 < length ? &nodes[i + 1] : NULL;
+    }
+
+    return length > 0 ? nodes : NULL;
+}
+
+int checkList(struct SLLNode *node, int expectedLength)
+{
+    int length = 0;
+
+    while (node)
+    {
+        if (node->nextNode && node->key > node->nextNode->key)
+            return 0;
+        node = node->nextNode;
+        length++;
+    }
+
+    return length == expectedLength;
+}
+
+void runCase(const char *name, char **values, int length)
+{
+    struct SLLNode *list = NULL;
+    double start = 0, quickSortTime = 0, mergeSortTime = 0;
+    int isQuickSortValid = 0, isMergeSortValid = 0;
+
+    list = buildList(values, length);
+    start = getSeconds();
+    isQuickSortValid = checkList(quickSort(list, length), length);
+    quickSortTime = getSeconds() - start;
+    free(list);
+
+    list = buildList(values, length);
+    start = getSeconds();
+    isMergeSortValid = checkList(mergeSort(list), length);
+    mergeSortTime = getSeconds() - start;
+    free(list);
+
+    printf("%-22s %10d  quickSort %8.3f s %-7s  mergeSort %8.3f s %-7s\n",
+           name, length,
+           quickSortTime, isQuickSortValid ? "ok" : "INVALID",
+           mergeSortTime, isMergeSortValid ? "ok" : "INVALID");
+}
+
+void runBuildCase(char **values, int length)
+{
+    struct SLL *sll = NULL;
+    double start = 0, addNodeTime = 0, appendManyTime = 0;
+    int batchLength = 1000000;
+
+    sll = getSLL();
+    start = getSeconds();
+    for (int i = 0; i < length; i++)
+        sll->addNode(sll, values[i]);
+    addNodeTime = getSeconds() - start;
+
+    sll = getSLL();
+    start = getSeconds();
+    for (int i = 0; i < length; i += batchLength)
+        sll->appendMany(sll, values + i, length - i < batchLength ? length - i : batchLength);
+    appendManyTime = getSeconds() - start;
+
+    printf("%-22s %10d  addNode   %8.3f s %-7s  appendMany %7.3f s %-7s\n",
+           "build", length,
+           addNodeTime, "",
+           appendManyTime, sll->length == length ? "ok" : "INVALID");
+}
+
+// Writes values into a temporary file, one per line, and builds a list from
+// it twice. Both lists must hold the same values in the same order.
+void runLoadCase(char **values, int length)
+{
+    char path[] = "/tmp/sll-benchmark-XXXXXX", line[4096];
+    struct SLL *sll = NULL, *loadedSll = NULL;
+    struct SLLNode *node = NULL, *loadedNode = NULL;
+    double start = 0, readTime = 0, loadTime = 0;
+    int fd = mkstemp(path), isValid = 1;
+    FILE *file = fdopen(fd, "w");
+
+    for (int i = 0; i < length; i++)
+    {
+        fputs(values[i], file);
+        fputc('\n', file);
+    }
+    fclose(file);
+
+    sll = getSLL();
+    start = getSeconds();
+    file = fopen(path, "r");
+    while (fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\n")] = '\0';
+        sll->addNode(sll, strdup(line));
+    }
+    fclose(file);
+    readTime = getSeconds() - start;
+
+    start = getSeconds();
+    loadedSll = loadSLLFromFile(path);
+    loadTime = getSeconds() - start;
+    unlink(path);
+
+    isValid = loadedSll && loadedSll->length == sll->length;
+    for (node = sll->firstNode, loadedNode = isValid ? loadedSll->firstNode : NULL; node && loadedNode && isValid;
+         node = node->nextNode, loadedNode = loadedNode->nextNode)
+        isValid = node->key == loadedNode->key && _isNodeValue(loadedNode, node->value);
+
+    printf("%-22s %10d  fgets    %9.3f s %-7s  mmap     %9.3f s %-7s\n",
+           "load file", length, readTime, "", loadTime, isValid ? "ok" : "INVALID");
+
+    if (loadedSll)
+        unloadSLL(loadedSll);
+}
+
+int checkUnrolledList(struct SLL *sll)
+{
+    struct SLLBlock *block = sll->firstBlock;
+    long long prevKey = 0;
+    int length = 0;
+
+    while (block)
+    {
+        for (int i = 0; i < block->length; i++, length++)
+        {
+            if (length > 0 && prevKey > block->keys[i])
+                return 0;
+            prevKey = block->keys[i];
+        }
+        block = block->nextBlock;
+    }
+
+    return length == sll->length;
+}
+
+void runBackendCase(const char *name, struct SLL *sll, char **values, int length)
+{
+    double start = 0, sortTime = 0, scanTime = 0;
+    int isValid = 0;
+
+    sll->appendMany(sll, values, length);
+
+    start = getSeconds();
+    sll->sortList(sll);
+    sortTime = getSeconds() - start;
+
+    isValid = sll->firstBlock ? checkUnrolledList(sll) : checkList(sll->firstNode, length);
+
+    start = getSeconds();
+    sll->deleteNode(sll, "missing value");
+    scanTime = getSeconds() - start;
+
+    printf("%-22s %10d  sortList  %8.3f s %-7s  full scan %8.3f s\n",
+           name, length, sortTime, isValid ? "ok" : "INVALID", scanTime);
+}
+
+void runDeleteCase(char **values, int length, int deleteLength)
+{
+    struct SLL *sll = NULL, *indexedSll = NULL;
+    double start = 0, deleteTime = 0, indexedDeleteTime = 0;
+
+    sll = getSLL();
+    sll->appendMany(sll, values, length);
+    indexedSll = getSLL();
+    indexedSll->enableIndex(indexedSll);
+    indexedSll->appendMany(indexedSll, values, length);
+
+    start = getSeconds();
+    for (int i = 0; i < deleteLength; i++)
+        sll->deleteNode(sll, values[(i * 7919L) % length]);
+    deleteTime = getSeconds() - start;
+
+    start = getSeconds();
+    for (int i = 0; i < deleteLength; i++)
+        indexedSll->deleteNode(indexedSll, values[(i * 7919L) % length]);
+    indexedDeleteTime = getSeconds() - start;
+
+    printf("%-22s %10d  deleteNode %7.3f s %-7s  indexed  %9.3f s %-7s\n",
+           "bulk delete", deleteLength,
+           deleteTime, "",
+           indexedDeleteTime, sll->length == indexedSll->length ? "ok" : "INVALID");
+}
+
+void runSumStringCase(const char *name, char **values, int length)
+{
+    long long *sums = (long long *)malloc(sizeof(long long) * length);
+    double start = 0, scalarTime = 0, batchTime = 0;
+    int isValid = 1;
+
+    start = getSeconds();
+    for (int i = 0; i < length; i++)
+        sums[i] = sumStringScalar(values[i]);
+    scalarTime = getSeconds() - start;
+
+    start = getSeconds();
+    sumStrings(values, sums, length);
+    batchTime = getSeconds() - start;
+
+    for (int i = 0; i < length && isValid; i++)
+        isValid = sums[i] == sumStringScalar(values[i]);
+
+    printf("%-22s %10d  scalar   %9.3f s %-7s  sumStrings %7.3f s %-7s\n",
+           name, length, scalarTime, "", batchTime, isValid ? "ok" : "INVALID");
+    free(sums);
+}
+
+void runLexicographicCase(const char *name, struct SLL *sll, char **values, int length)
+{
+    double start = 0, sortTime = 0;
+    char *prevValue = NULL;
+    int isValid = 1, sortedLength = 0;
+
+    sll->appendMany(sll, values, length);
+
+    start = getSeconds();
+    sll->sortListLexicographic(sll);
+    sortTime = getSeconds() - start;
+
+    if (sll->firstBlock)
+    {
+        for (struct SLLBlock *block = sll->firstBlock; block; block = block->nextBlock)
+        {
+            for (int i = 0; i < block->length; i++, sortedLength++)
+            {
+                isValid = isValid && (prevValue == NULL || strcmp(prevValue, block->values[i]) <= 0);
+                prevValue = block->values[i];
+            }
+        }
+    }
+    else
+    {
+        for (struct SLLNode *node = sll->firstNode; node; node = node->nextNode, sortedLength++)
+        {
+            isValid = isValid && (prevValue == NULL || strcmp(prevValue, node->value) <= 0);
+            prevValue = node->value;
+        }
+    }
+
+    printf("%-22s %10d  radix sort %7.3f s %-7s\n",
+           name, length, sortTime, isValid && sortedLength == length ? "ok" : "INVALID");
+}
+
+// Adds values in batches and keeps the list sorted after every batch, once by
+// sorting the whole node list again and once with the sorted list. Then every
+// value is looked up and deleted from the sorted list.
+void runSortedCase(char **values, int length, int batchLength)
+{
+    struct SLL *sll = getSLL(), *sortedSll = getSortedSLL();
+    double start = 0, resortTime = 0, sortedTime = 0, deleteTime = 0;
+    int isValid = 1;
+
+    start = getSeconds();
+    for (int i = 0; i < length; i += batchLength)
+    {
+        sll->appendMany(sll, values + i, i + batchLength < length ? batchLength : length - i);
+        sll->sortList(sll);
+    }
+    resortTime = getSeconds() - start;
+
+    start = getSeconds();
+    for (int i = 0; i < length; i++)
+        sortedSll->addNode(sortedSll, values[i]);
+    sortedTime = getSeconds() - start;
+
+    isValid = checkList(sortedSll->firstNode, length);
+    for (struct SLLNode *node = sll->firstNode, *sortedNode = sortedSll->firstNode; node && isValid;
+         node = node->nextNode, sortedNode = sortedNode->nextNode)
+        isValid = node->key == sortedNode->key;
+
+    start = getSeconds();
+    for (int i = 0; i < length && isValid; i++)
+    {
+        isValid = sortedSll->findNode(sortedSll, values[i]) != NULL;
+        sortedSll->deleteNode(sortedSll, values[i]);
+    }
+    deleteTime = getSeconds() - start;
+
+    printf("%-22s %10d  resort   %9.3f s %-7s  skip list %8.3f s %-7s  find+delete %6.3f s\n",
+           "sorted batches", length, resortTime, "", sortedTime,
+           isValid && sortedSll->length == 0 && sortedSll->firstNode == NULL ? "ok" : "INVALID", deleteTime);
+}
+
+char *randomString(int maxLength)
+{
+    int length = 1 + rand() % maxLength;
+    char *str = (char *)malloc(length + 1);
+
+    for (int i = 0; i < length; i++)
+        str[i] = 'a' + rand() % 26;
+    str[length] = '\0';
+
+    return str;
+}
+
+// Strings whose keys strictly grow with the index, one character repeated,
+// longer strings always have larger keys than shorter ones.
+char **getAscendingValues(int length)
+{
+    char **values = (char **)malloc(sizeof(char *) * length);
+
+    for (int i = 0; i < length; i++)
+    {
+        int strLength = 1 + i / 94;
+        values[i] = (char *)malloc(strLength + 1);
+        memset(values[i], '!' + i % 94, strLength);
+        values[i][strLength] = '\0';
+    }
+
+    return values;
+}
+
+// Orders ascending values so that the middle node quickSort picks as pivot
+// is always the smallest key left, every partition then drops one node.
+char **getMiddlePivotKillerValues(int length)
+{
+    char **ascending = getAscendingValues(length);
+    char **values = (char **)malloc(sizeof(char *) * length);
+    int *positions = (int *)malloc(sizeof(int) * length);
+    int positionsLength = length;
+
+    for (int i = 0; i < length; i++)
+        positions[i] = i;
+
+    for (int i = 0; i < length; i++)
+    {
+        int middleIndex = positionsLength / 2;
+        values[positions[middleIndex]] = ascending[i];
+        memmove(positions + middleIndex, positions + middleIndex + 1, sizeof(int) * (positionsLength - middleIndex - 1));
+        positionsLength--;
+    }
+
+    free(positions);
+    free(ascending);
+    return values;
+}
+
+int main(int argc, char **argv)
+{
+    int length = argc > 1 ? atoi(argv[1]) : 10000000;
+    int adversarialLength = argc > 2 ? atoi(argv[2]) : 20000;
+    char **values = (char **)malloc(sizeof(char *) * length);
+
+    srand(83663);
+
+    for (int i = 0; i < length; i++)
+        values[i] = randomString(16);
+    runSumStringCase("sumString", values, length);
+    runBuildCase(values, length);
+    runLoadCase(values, length);
+    runCase("random", values, length);
+    runBackendCase("nodes", getSLL(), values, length);
+    runBackendCase("unrolled", getUnrolledSLL(), values, length);
+    runDeleteCase(values, length, 2000);
+    runLexicographicCase("lexicographic nodes", getSLL(), values, length);
+    runLexicographicCase("lexicographic unrolled", getUnrolledSLL(), values, length);
+    runSortedCase(values, length / 100, 1000);
+
+    for (int i = 0; i < length; i++)
+        values[i] = i % 2 == 0 ? values[i] : values[i - 1];
+    runCase("random, duplicates", values, length);
+
+    for (int i = 0; i < length / 100; i++)
+        values[i] = randomString(4096);
+    runSumStringCase("sumString, long", values, length / 100);
+
+    runCase("ascending", getAscendingValues(adversarialLength), adversarialLength);
+    runCase("middle pivot killer", getMiddlePivotKillerValues(adversarialLength), adversarialLength);
+
+    return 0;
+}
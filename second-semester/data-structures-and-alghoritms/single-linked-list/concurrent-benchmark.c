@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include "./sll.h"
+#include "./concurrent-sll.h"
+
+// Contention benchmark for the lock-free list against SLL from getSLL
+// protected by one mutex. Every thread adds its own values and deletes the
+// value it added CONCURRENT_BENCHMARK_WINDOW / 2 operations earlier, so all
+// threads append to and delete from the same short list all the time. At the
+// end every thread deletes what is left, list must be empty and every delete
+// of the lock-free list must find its value.
+//
+// Build: gcc -O2 concurrent-benchmark.c concurrent-sll.c sll.c sll-index.c sll-file.c unrolled-sll.c radix-sort.c skip-list.c utils.c -o concurrent-benchmark -pthread
+// Usage: ./concurrent-benchmark [operations per thread]
+
+#define CONCURRENT_BENCHMARK_WINDOW 16
+
+struct BenchmarkContext
+{
+    struct ConcurrentSLL *concurrentSll;
+    struct SLL *sll;
+    pthread_mutex_t mutex;
+    pthread_barrier_t barrier;
+    int operationLength;
+    atomic_int missedDeletes;
+};
+
+struct BenchmarkThread
+{
+    struct BenchmarkContext *context;
+    char *values[CONCURRENT_BENCHMARK_WINDOW];
+};
+
+double getSeconds()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+void *runConcurrentThread(void *argument)
+{
+    struct BenchmarkThread *benchmarkThread = (struct BenchmarkThread *)argument;
+    struct BenchmarkContext *context = benchmarkThread->context;
+    struct ConcurrentSLL *sll = context->concurrentSll;
+    int threadId = sll->registerThread(sll);
+    int half = CONCURRENT_BENCHMARK_WINDOW / 2, missedDeletes = 0;
+
+    pthread_barrier_wait(&context->barrier);
+
+    for (int i = 0; i < context->operationLength; i++)
+    {
+        sll->addNode(sll, threadId, benchmarkThread->values[i % CONCURRENT_BENCHMARK_WINDOW]);
+        if (i >= half)
+            missedDeletes += !sll->deleteNode(sll, threadId, benchmarkThread->values[(i - half) % CONCURRENT_BENCHMARK_WINDOW]);
+    }
+    for (int i = context->operationLength - half; i < context->operationLength; i++)
+    {
+        if (i >= 0)
+            missedDeletes += !sll->deleteNode(sll, threadId, benchmarkThread->values[i % CONCURRENT_BENCHMARK_WINDOW]);
+    }
+
+    atomic_fetch_add(&context->missedDeletes, missedDeletes);
+    sll->unregisterThread(sll, threadId);
+
+    return NULL;
+}
+
+void *runMutexThread(void *argument)
+{
+    struct BenchmarkThread *benchmarkThread = (struct BenchmarkThread *)argument;
+    struct BenchmarkContext *context = benchmarkThread->context;
+    struct SLL *sll = context->sll;
+    int half = CONCURRENT_BENCHMARK_WINDOW / 2;
+
+    pthread_barrier_wait(&context->barrier);
+
+    for (int i = 0; i < context->operationLength; i++)
+    {
+        pthread_mutex_lock(&context->mutex);
+        sll->addNode(sll, benchmarkThread->values[i % CONCURRENT_BENCHMARK_WINDOW]);
+        pthread_mutex_unlock(&context->mutex);
+
+        if (i >= half)
+        {
+            pthread_mutex_lock(&context->mutex);
+            sll->deleteNode(sll, benchmarkThread->values[(i - half) % CONCURRENT_BENCHMARK_WINDOW]);
+            pthread_mutex_unlock(&context->mutex);
+        }
+    }
+    for (int i = context->operationLength - half; i < context->operationLength; i++)
+    {
+        if (i >= 0)
+        {
+            pthread_mutex_lock(&context->mutex);
+            sll->deleteNode(sll, benchmarkThread->values[i % CONCURRENT_BENCHMARK_WINDOW]);
+            pthread_mutex_unlock(&context->mutex);
+        }
+    }
+
+    return NULL;
+}
+
+// Runs threadLength threads over the same list and prints operations per
+// second, every add and every delete is one operation.
+void runCase(const char *name, int isConcurrent, int threadLength, int operationLength)
+{
+    struct BenchmarkContext context;
+    struct BenchmarkThread *benchmarkThreads = (struct BenchmarkThread *)malloc(sizeof(struct BenchmarkThread) * threadLength);
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * threadLength);
+    double start = 0, time = 0;
+    int isValid = 0;
+
+    context.concurrentSll = isConcurrent ? getConcurrentSLL() : NULL;
+    context.sll = isConcurrent ? NULL : getSLL();
+    pthread_mutex_init(&context.mutex, NULL);
+    pthread_barrier_init(&context.barrier, NULL, threadLength + 1);
+    context.operationLength = operationLength;
+    atomic_init(&context.missedDeletes, 0);
+
+    for (int i = 0; i < threadLength; i++)
+    {
+        benchmarkThreads[i].context = &context;
+        for (int j = 0; j < CONCURRENT_BENCHMARK_WINDOW; j++)
+        {
+            benchmarkThreads[i].values[j] = (char *)malloc(32);
+            snprintf(benchmarkThreads[i].values[j], 32, "thread %d value %d", i, j);
+        }
+        pthread_create(&threads[i], NULL, isConcurrent ? runConcurrentThread : runMutexThread, &benchmarkThreads[i]);
+    }
+
+    pthread_barrier_wait(&context.barrier);
+    start = getSeconds();
+    for (int i = 0; i < threadLength; i++)
+        pthread_join(threads[i], NULL);
+    time = getSeconds() - start;
+
+    if (isConcurrent)
+    {
+        isValid = atomic_load(&context.concurrentSll->length) == 0 &&
+                  atomic_load(&context.concurrentSll->head.nextNode) == 0 &&
+                  atomic_load(&context.missedDeletes) == 0;
+        freeConcurrentSLL(context.concurrentSll);
+    }
+    else
+    {
+        isValid = context.sll->length == 0 && context.sll->firstNode == NULL;
+        free(context.sll);
+    }
+
+    printf("%-10s %3d threads  %12.0f ops/s  %s\n",
+           name, threadLength, 2.0 * threadLength * operationLength / time, isValid ? "ok" : "INVALID");
+
+    for (int i = 0; i < threadLength; i++)
+        for (int j = 0; j < CONCURRENT_BENCHMARK_WINDOW; j++)
+            free(benchmarkThreads[i].values[j]);
+    pthread_barrier_destroy(&context.barrier);
+    pthread_mutex_destroy(&context.mutex);
+    free(benchmarkThreads);
+    free(threads);
+}
+
+int main(int argc, char **argv)
+{
+    int operationLength = argc > 1 ? atoi(argv[1]) : 200000;
+
+    for (int threadLength = 1; threadLength <= CONCURRENT_SLL_MAX_THREADS; threadLength *= 2)
+    {
+        runCase("lock-free", 1, threadLength, operationLength);
+        runCase("mutex", 0, threadLength, operationLength);
+    }
+
+    return 0;
+}
@@ -0,0 +1,304 @@
+#include "./concurrent-sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include "./utils.h"
+
+// Lock-free singly linked list for many producer threads. addNode appends
+// with compare-and-swap on nextNode of the last node, which is found from
+// lastNodeHint instead of walking from the head, deleting the node under the
+// hint moves the hint to its predecessor. deleteNode first marks the
+// node as deleted by setting the lowest bit of its nextNode and then unlinks
+// it, threads which see a marked node on their way unlink it themselves
+// (Harris list with Michael's unlinking, traversal never passes a marked
+// node). Unlinked nodes are freed with epoch-based reclamation, a node
+// unlinked in epoch e is freed once the global epoch is e + 3, one epoch
+// more than usual because lastNodeHint may point at the node for a short
+// time after it was unlinked.
+//
+// Every thread calls registerThread once and passes the returned id to other
+// procedures. When no thread is changing the list it can be walked from
+// head.nextNode with _getConcurrentNode.
+
+struct ConcurrentSLLNode *_getConcurrentNode(uintptr_t nextNode)
+{
+    return (struct ConcurrentSLLNode *)(nextNode & ~(uintptr_t)1);
+}
+
+int _isMarked(uintptr_t nextNode)
+{
+    return (nextNode & 1) != 0;
+}
+
+// Returns id of a free thread slot or -1 when all CONCURRENT_SLL_MAX_THREADS
+// are taken.
+int registerThread(struct ConcurrentSLL *self)
+{
+    for (int i = 0; i < CONCURRENT_SLL_MAX_THREADS; i++)
+    {
+        int isUsed = 0;
+        if (atomic_compare_exchange_strong(&self->threads[i].isUsed, &isUsed, 1))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// Retired nodes of the slot stay there and are freed by the next owner.
+void unregisterThread(struct ConcurrentSLL *self, int threadId)
+{
+    atomic_store(&self->threads[threadId].isUsed, 0);
+}
+
+void _enterEpoch(struct ConcurrentSLL *self, int threadId)
+{
+    unsigned long epoch = atomic_load(&self->epoch);
+    atomic_store(&self->threads[threadId].state, (epoch << 1) | 1);
+}
+
+void _exitEpoch(struct ConcurrentSLL *self, int threadId)
+{
+    atomic_store_explicit(&self->threads[threadId].state, 0, memory_order_release);
+}
+
+// Epoch moves forward only when every thread inside an operation has seen
+// the current epoch.
+void _tryAdvanceEpoch(struct ConcurrentSLL *self)
+{
+    unsigned long epoch = atomic_load(&self->epoch);
+
+    for (int i = 0; i < CONCURRENT_SLL_MAX_THREADS; i++)
+    {
+        unsigned long state = atomic_load(&self->threads[i].state);
+        if ((state & 1) && (state >> 1) != epoch)
+            return;
+    }
+
+    atomic_compare_exchange_strong(&self->epoch, &epoch, epoch + 1);
+}
+
+void _retireNode(struct ConcurrentSLL *self, int threadId, struct ConcurrentSLLNode *node)
+{
+    struct ConcurrentSLLThread *thread = &self->threads[threadId];
+
+    node->retireEpoch = atomic_load(&self->epoch);
+    node->nextRetiredNode = NULL;
+    if (thread->lastRetiredNode)
+    {
+        thread->lastRetiredNode->nextRetiredNode = node;
+    }
+    else
+    {
+        thread->firstRetiredNode = node;
+    }
+    thread->lastRetiredNode = node;
+    thread->retiredLength++;
+
+    if (thread->retiredLength >= CONCURRENT_SLL_RECLAIM_LENGTH)
+    {
+        _tryAdvanceEpoch(self);
+        _freeRetiredNodes(self, thread);
+    }
+}
+
+// Retired list is in retire order, so freeing stops at the first node which
+// is still too young.
+void _freeRetiredNodes(struct ConcurrentSLL *self, struct ConcurrentSLLThread *thread)
+{
+    unsigned long epoch = atomic_load(&self->epoch);
+
+    while (thread->firstRetiredNode && thread->firstRetiredNode->retireEpoch + 3 <= epoch)
+    {
+        struct ConcurrentSLLNode *node = thread->firstRetiredNode;
+        thread->firstRetiredNode = node->nextRetiredNode;
+        thread->retiredLength--;
+        free(node);
+    }
+
+    if (thread->firstRetiredNode == NULL)
+    {
+        thread->lastRetiredNode = NULL;
+    }
+}
+
+// Unlinks marked node from unmarked prevNode. Only the thread whose
+// compare-and-swap succeeds retires the node, lastNodeHint is moved off the
+// node to prevNode before that, so appends after deleting the last node still
+// start next to the end. prevNode may be deleted at the same time, its
+// deleter moves the hint on when it sees prevNode there, otherwise the mark
+// is seen here and the hint goes to the head.
+int _unlinkNode(struct ConcurrentSLL *self, int threadId, struct ConcurrentSLLNode *prevNode, struct ConcurrentSLLNode *node, uintptr_t nextNode)
+{
+    uintptr_t expected = (uintptr_t)node;
+    struct ConcurrentSLLNode *hint = node;
+
+    if (!atomic_compare_exchange_strong(&prevNode->nextNode, &expected, nextNode))
+        return 0;
+
+    if (atomic_compare_exchange_strong(&self->lastNodeHint, &hint, prevNode) && _isMarked(atomic_load(&prevNode->nextNode)))
+    {
+        hint = prevNode;
+        atomic_compare_exchange_strong(&self->lastNodeHint, &hint, &self->head);
+    }
+    _retireNode(self, threadId, node);
+
+    return 1;
+}
+
+void addNodeConcurrent(struct ConcurrentSLL *self, int threadId, char *value)
+{
+    struct ConcurrentSLLNode *newNode = (struct ConcurrentSLLNode *)malloc(sizeof(struct ConcurrentSLLNode));
+    struct ConcurrentSLLNode *prevNode = NULL, *node = NULL, *hint = NULL;
+    uintptr_t nextNode = 0, afterNode = 0;
+
+    atomic_init(&newNode->nextNode, 0);
+    newNode->value = value;
+    newNode->key = sumString(value);
+
+    _enterEpoch(self, threadId);
+
+    prevNode = atomic_load(&self->lastNodeHint);
+    while (1)
+    {
+        nextNode = atomic_load(&prevNode->nextNode);
+
+        // node the search stands on was deleted, start again from the head
+        if (_isMarked(nextNode))
+        {
+            prevNode = &self->head;
+            continue;
+        }
+
+        node = _getConcurrentNode(nextNode);
+        if (node == NULL)
+        {
+            if (atomic_compare_exchange_strong(&prevNode->nextNode, &nextNode, (uintptr_t)newNode))
+                break;
+            continue;
+        }
+
+        afterNode = atomic_load(&node->nextNode);
+        if (_isMarked(afterNode))
+        {
+            _unlinkNode(self, threadId, prevNode, node, afterNode & ~(uintptr_t)1);
+            continue;
+        }
+
+        prevNode = node;
+    }
+
+    // new node may have been deleted already, then the hint must not keep it
+    atomic_store(&self->lastNodeHint, newNode);
+    if (_isMarked(atomic_load(&newNode->nextNode)))
+    {
+        hint = newNode;
+        atomic_compare_exchange_strong(&self->lastNodeHint, &hint, &self->head);
+    }
+    atomic_fetch_add(&self->length, 1);
+
+    _exitEpoch(self, threadId);
+}
+
+// Deletes the first node with the given value, returns 1 when a node was
+// deleted. The node is deleted once it is marked, if unlinking fails some
+// later traversal unlinks it.
+int deleteNodeConcurrent(struct ConcurrentSLL *self, int threadId, char *value)
+{
+    struct ConcurrentSLLNode *prevNode = &self->head, *node = NULL;
+    uintptr_t nextNode = 0, afterNode = 0;
+    long long key = sumString(value);
+
+    _enterEpoch(self, threadId);
+
+    while (1)
+    {
+        nextNode = atomic_load(&prevNode->nextNode);
+
+        if (_isMarked(nextNode))
+        {
+            prevNode = &self->head;
+            continue;
+        }
+
+        node = _getConcurrentNode(nextNode);
+        if (node == NULL)
+            break;
+
+        afterNode = atomic_load(&node->nextNode);
+        if (_isMarked(afterNode))
+        {
+            _unlinkNode(self, threadId, prevNode, node, afterNode & ~(uintptr_t)1);
+            continue;
+        }
+
+        if (node->key == key && strcmp(node->value, value) == 0)
+        {
+            if (!atomic_compare_exchange_strong(&node->nextNode, &afterNode, afterNode | 1))
+                continue;
+
+            atomic_fetch_sub(&self->length, 1);
+            _unlinkNode(self, threadId, prevNode, node, afterNode);
+            _exitEpoch(self, threadId);
+            return 1;
+        }
+
+        prevNode = node;
+    }
+
+    _exitEpoch(self, threadId);
+    return 0;
+}
+
+struct ConcurrentSLL *getConcurrentSLL()
+{
+    size_t size = (sizeof(struct ConcurrentSLL) + 63) / 64 * 64;
+    struct ConcurrentSLL *newSll = (struct ConcurrentSLL *)aligned_alloc(64, size);
+
+    atomic_init(&newSll->head.nextNode, 0);
+    newSll->head.value = NULL;
+    newSll->head.key = 0;
+    atomic_init(&newSll->lastNodeHint, &newSll->head);
+    atomic_init(&newSll->length, 0);
+    atomic_init(&newSll->epoch, 0);
+    for (int i = 0; i < CONCURRENT_SLL_MAX_THREADS; i++)
+    {
+        atomic_init(&newSll->threads[i].isUsed, 0);
+        atomic_init(&newSll->threads[i].state, 0);
+        newSll->threads[i].firstRetiredNode = NULL;
+        newSll->threads[i].lastRetiredNode = NULL;
+        newSll->threads[i].retiredLength = 0;
+    }
+    newSll->registerThread = *registerThread;
+    newSll->unregisterThread = *unregisterThread;
+    newSll->addNode = *addNodeConcurrent;
+    newSll->deleteNode = *deleteNodeConcurrent;
+
+    return newSll;
+}
+
+// Frees the list with all nodes, no thread may use the list any more.
+void freeConcurrentSLL(struct ConcurrentSLL *self)
+{
+    struct ConcurrentSLLNode *node = _getConcurrentNode(atomic_load(&self->head.nextNode)), *nextNode = NULL;
+
+    while (node)
+    {
+        nextNode = _getConcurrentNode(atomic_load(&node->nextNode));
+        free(node);
+        node = nextNode;
+    }
+
+    for (int i = 0; i < CONCURRENT_SLL_MAX_THREADS; i++)
+    {
+        node = self->threads[i].firstRetiredNode;
+        while (node)
+        {
+            nextNode = node->nextRetiredNode;
+            free(node);
+            node = nextNode;
+        }
+    }
+
+    free(self);
+}
@@ -0,0 +1,58 @@
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define CONCURRENT_SLL_MAX_THREADS 64
+#define CONCURRENT_SLL_RECLAIM_LENGTH 64
+
+// Node of the lock-free list. Lowest bit of nextNode is set when the node is
+// deleted, after that nextNode never changes. Retired fields are only used
+// by the thread which unlinked the node.
+struct ConcurrentSLLNode
+{
+    _Atomic uintptr_t nextNode;
+    char *value;
+    long long key;
+    struct ConcurrentSLLNode *nextRetiredNode;
+    unsigned long retireEpoch;
+};
+
+// Epoch state of one registered thread. state is 0 between operations,
+// during an operation it is the epoch seen at the start shifted left by one
+// with the lowest bit set. Unlinked nodes wait in the retired list until
+// every thread has left the epoch they were unlinked in.
+struct ConcurrentSLLThread
+{
+    _Alignas(64) atomic_int isUsed;
+    _Atomic unsigned long state;
+    struct ConcurrentSLLNode *firstRetiredNode;
+    struct ConcurrentSLLNode *lastRetiredNode;
+    int retiredLength;
+};
+
+struct ConcurrentSLL
+{
+    struct ConcurrentSLLNode head;
+    _Atomic(struct ConcurrentSLLNode *) lastNodeHint;
+    atomic_int length;
+    _Atomic unsigned long epoch;
+    struct ConcurrentSLLThread threads[CONCURRENT_SLL_MAX_THREADS];
+    int (*registerThread)(struct ConcurrentSLL *self);
+    void (*unregisterThread)(struct ConcurrentSLL *self, int threadId);
+    void (*addNode)(struct ConcurrentSLL *self, int threadId, char *value);
+    int (*deleteNode)(struct ConcurrentSLL *self, int threadId, char *value);
+};
+
+struct ConcurrentSLLNode *_getConcurrentNode(uintptr_t nextNode);
+int _isMarked(uintptr_t nextNode);
+int registerThread(struct ConcurrentSLL *self);
+void unregisterThread(struct ConcurrentSLL *self, int threadId);
+void addNodeConcurrent(struct ConcurrentSLL *self, int threadId, char *value);
+int deleteNodeConcurrent(struct ConcurrentSLL *self, int threadId, char *value);
+void _enterEpoch(struct ConcurrentSLL *self, int threadId);
+void _exitEpoch(struct ConcurrentSLL *self, int threadId);
+void _tryAdvanceEpoch(struct ConcurrentSLL *self);
+void _retireNode(struct ConcurrentSLL *self, int threadId, struct ConcurrentSLLNode *node);
+void _freeRetiredNodes(struct ConcurrentSLL *self, struct ConcurrentSLLThread *thread);
+int _unlinkNode(struct ConcurrentSLL *self, int threadId, struct ConcurrentSLLNode *prevNode, struct ConcurrentSLLNode *node, uintptr_t nextNode);
+struct ConcurrentSLL *getConcurrentSLL();
+void freeConcurrentSLL(struct ConcurrentSLL *self);
\ No newline at end of file
@@ -17,6 +17,16 @@ int main()
     sll->addNode(sll, "13");
     sll->addNode(sll, "4");
 
+    // Add several values at once
+    char *values[] = {"21", "1"};
+    sll->appendMany(sll, values, 2);
+
+    // Move nodes of another list to the end
+    struct SLL *otherSll = getSLL();
+    otherSll->addNode(otherSll, "9");
+    otherSll->addNode(otherSll, "10");
+    sll->splice(sll, otherSll);
+
     // Delete node by value
     sll->deleteNode(sll, "3");
 
@@ -32,7 +42,7 @@ int main()
     sll->sortList(sll);
 
     // Print singly linked list after sorting
-    printf("\n\nQuick sort:\n");
+    printf("\n\nMerge sort:\n");
     node = sll->firstNode;
     while (node != NULL)
     {
@@ -0,0 +1,343 @@
+#include "./sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "./utils.h"
+
+// Lexicographic sort of a list. Values are gathered into an array of items
+// which also keep 8 bytes of the value starting at the current depth, so the
+// radix passes mostly read the array and not the strings. The array is
+// sorted with in-place MSD radix sort (American flag sort) one byte at a
+// time, large buckets are handed to a pool of threads, small buckets are
+// finished with insertion sort. Buckets wait on an explicit stack, there is
+// no recursion, so depth of shared prefixes does not matter. Order is the
+// order of strcmp, equal values may change their relative order. Values are
+// compared by their length, so lines of a loaded list which are not followed
+// by '\0' sort like strings ending after them.
+
+#define SLL_SORT_INSERTION_LENGTH 32
+#define SLL_SORT_PARALLEL_LENGTH 65536
+
+struct SLLSortItem
+{
+    unsigned long long prefix;
+    char *value;
+    struct SLLNode *node;
+    int length;
+};
+
+struct SLLSortTask
+{
+    struct SLLSortItem *items;
+    int length;
+    int depth;
+};
+
+struct SLLSortTaskStack
+{
+    struct SLLSortTask *tasks;
+    int length;
+    int capacity;
+};
+
+struct SLLSortPool
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    struct SLLSortTaskStack stack;
+    int activeWorkers;
+    int workerCount;
+};
+
+void _pushSortTask(struct SLLSortTaskStack *stack, struct SLLSortItem *items, int length, int depth)
+{
+    if (stack->length == stack->capacity)
+    {
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 256;
+        stack->tasks = (struct SLLSortTask *)realloc(stack->tasks, sizeof(struct SLLSortTask) * stack->capacity);
+    }
+
+    stack->tasks[stack->length].items = items;
+    stack->tasks[stack->length].length = length;
+    stack->tasks[stack->length].depth = depth;
+    stack->length++;
+}
+
+// Big-endian load of up to 8 of length bytes of the value, bytes after the
+// end are zero, so the first byte of the prefix is the byte at depth.
+unsigned long long _loadSortPrefix(char *value, int length)
+{
+    unsigned long long prefix = 0;
+    int i = 0;
+
+    for (; i < 8 && i < length; i++)
+    {
+        prefix = (prefix << 8) | (unsigned char)value[i];
+    }
+
+    return i == 0 ? 0 : prefix << (8 * (8 - i));
+}
+
+int _getSortByte(struct SLLSortItem *item, int depth)
+{
+    return (item->prefix >> (56 - 8 * (depth & 7))) & 0xFF;
+}
+
+// Compares values of two items from depth on like strcmp.
+int _compareSortItems(struct SLLSortItem *first, struct SLLSortItem *second, int depth)
+{
+    int firstLength = first->length > depth ? first->length - depth : 0;
+    int secondLength = second->length > depth ? second->length - depth : 0;
+    int result = memcmp(first->value + depth, second->value + depth, firstLength < secondLength ? firstLength : secondLength);
+
+    return result != 0 ? result : firstLength - secondLength;
+}
+
+void _insertionSortItems(struct SLLSortItem *items, int length, int depth)
+{
+    for (int i = 1; i < length; i++)
+    {
+        struct SLLSortItem item = items[i];
+        int j = i - 1;
+
+        while (j >= 0 && _compareSortItems(&items[j], &item, depth) > 0)
+        {
+            items[j + 1] = items[j];
+            j--;
+        }
+        items[j + 1] = item;
+    }
+}
+
+// Sorts one bucket and everything below it. Buckets of at least
+// SLL_SORT_PARALLEL_LENGTH items go to the pool when there are other workers.
+void _radixSortTask(struct SLLSortPool *pool, struct SLLSortTask rootTask)
+{
+    struct SLLSortTaskStack stack = {NULL, 0, 0};
+    int counts[256], nextIndexes[256], endIndexes[256];
+
+    _pushSortTask(&stack, rootTask.items, rootTask.length, rootTask.depth);
+
+    while (stack.length > 0)
+    {
+        struct SLLSortTask task = stack.tasks[--stack.length];
+        struct SLLSortItem *items = task.items;
+
+        if (task.length < SLL_SORT_INSERTION_LENGTH)
+        {
+            _insertionSortItems(items, task.length, task.depth);
+            continue;
+        }
+
+        // prefix ran out, take next 8 bytes of every value in the bucket
+        if (task.depth > 0 && (task.depth & 7) == 0)
+        {
+            for (int i = 0; i < task.length; i++)
+            {
+                items[i].prefix = _loadSortPrefix(items[i].value + task.depth, items[i].length - task.depth);
+            }
+        }
+
+        memset(counts, 0, sizeof(counts));
+        for (int i = 0; i < task.length; i++)
+        {
+            counts[_getSortByte(&items[i], task.depth)]++;
+        }
+
+        for (int b = 0, start = 0; b < 256; b++)
+        {
+            nextIndexes[b] = start;
+            start += counts[b];
+            endIndexes[b] = start;
+        }
+
+        // move every item to its bucket by following cycles of swaps
+        for (int b = 0; b < 256; b++)
+        {
+            while (nextIndexes[b] < endIndexes[b])
+            {
+                struct SLLSortItem item = items[nextIndexes[b]];
+                int itemByte = _getSortByte(&item, task.depth);
+
+                while (itemByte != b)
+                {
+                    struct SLLSortItem swapped = items[nextIndexes[itemByte]];
+                    items[nextIndexes[itemByte]++] = item;
+                    item = swapped;
+                    itemByte = _getSortByte(&item, task.depth);
+                }
+                items[nextIndexes[b]++] = item;
+            }
+        }
+
+        // bucket 0 holds values which ended at this depth, they are equal
+        for (int b = 1, start = counts[0]; b < 256; start += counts[b], b++)
+        {
+            if (counts[b] < 2)
+                continue;
+
+            if (counts[b] >= SLL_SORT_PARALLEL_LENGTH && pool->workerCount > 1)
+            {
+                pthread_mutex_lock(&pool->mutex);
+                _pushSortTask(&pool->stack, items + start, counts[b], task.depth + 1);
+                pthread_cond_signal(&pool->condition);
+                pthread_mutex_unlock(&pool->mutex);
+            }
+            else
+            {
+                _pushSortTask(&stack, items + start, counts[b], task.depth + 1);
+            }
+        }
+    }
+
+    free(stack.tasks);
+}
+
+void *_radixSortWorker(void *argument)
+{
+    struct SLLSortPool *pool = (struct SLLSortPool *)argument;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true)
+    {
+        while (pool->stack.length == 0 && pool->activeWorkers > 0)
+        {
+            pthread_cond_wait(&pool->condition, &pool->mutex);
+        }
+
+        if (pool->stack.length == 0)
+        {
+            // nothing left and nobody can add more
+            pthread_cond_broadcast(&pool->condition);
+            break;
+        }
+
+        struct SLLSortTask task = pool->stack.tasks[--pool->stack.length];
+        pool->activeWorkers++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        _radixSortTask(pool, task);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->activeWorkers--;
+        if (pool->activeWorkers == 0 && pool->stack.length == 0)
+        {
+            pthread_cond_broadcast(&pool->condition);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+void _radixSortItems(struct SLLSortItem *items, int length)
+{
+    struct SLLSortPool pool;
+    long workerCount = sysconf(_SC_NPROCESSORS_ONLN);
+    pthread_t *threads = NULL;
+
+    if (workerCount < 1 || length < SLL_SORT_PARALLEL_LENGTH)
+        workerCount = 1;
+
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.condition, NULL);
+    pool.stack.tasks = NULL;
+    pool.stack.length = 0;
+    pool.stack.capacity = 0;
+    pool.activeWorkers = 0;
+    pool.workerCount = workerCount;
+    _pushSortTask(&pool.stack, items, length, 0);
+
+    // calling thread is one of the workers
+    threads = (pthread_t *)malloc(sizeof(pthread_t) * workerCount);
+    for (int i = 1; i < workerCount; i++)
+    {
+        pthread_create(&threads[i], NULL, _radixSortWorker, &pool);
+    }
+    _radixSortWorker(&pool);
+    for (int i = 1; i < workerCount; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    free(pool.stack.tasks);
+    pthread_cond_destroy(&pool.condition);
+    pthread_mutex_destroy(&pool.mutex);
+}
+
+void sortListLexicographic(struct SLL *self)
+{
+    struct SLLSortItem *items = NULL;
+    struct SLLNode *node = self->firstNode;
+    int length = 0;
+
+    if (self->length < 2)
+        return;
+
+    items = (struct SLLSortItem *)malloc(sizeof(struct SLLSortItem) * self->length);
+    while (node)
+    {
+        items[length].prefix = _loadSortPrefix(node->value, node->valueLength);
+        items[length].value = node->value;
+        items[length].node = node;
+        items[length].length = node->valueLength;
+        length++;
+        node = node->nextNode;
+    }
+
+    _radixSortItems(items, length);
+
+    for (int i = 0; i < length - 1; i++)
+    {
+        items[i].node->nextNode = items[i + 1].node;
+    }
+    items[length - 1].node->nextNode = NULL;
+    self->firstNode = items[0].node;
+    self->lastNode = items[length - 1].node;
+    free(items);
+
+    if (self->index)
+    {
+        _rebuildIndex(self);
+    }
+}
+
+void sortListLexicographicUnrolled(struct SLL *self)
+{
+    struct SLLSortItem *items = NULL;
+    struct SLLBlock *block = self->firstBlock;
+    int length = 0;
+
+    if (self->length < 2)
+        return;
+
+    items = (struct SLLSortItem *)malloc(sizeof(struct SLLSortItem) * self->length);
+    for (; block; block = block->nextBlock)
+    {
+        for (int i = 0; i < block->length; i++)
+        {
+            items[length].length = strlen(block->values[i]);
+            items[length].prefix = _loadSortPrefix(block->values[i], items[length].length);
+            items[length].value = block->values[i];
+            items[length].node = NULL;
+            length++;
+        }
+    }
+
+    _radixSortItems(items, length);
+
+    // blocks keep their sizes, only values and keys move
+    length = 0;
+    for (block = self->firstBlock; block; block = block->nextBlock)
+    {
+        for (int i = 0; i < block->length; i++)
+        {
+            block->values[i] = items[length++].value;
+        }
+        sumStrings(block->values, block->keys, block->length);
+    }
+    free(items);
+}
@@ -0,0 +1,266 @@
+#include "./sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include "./utils.h"
+
+// Sorted singly linked list backed by a skip list. Every node is a
+// SLLSkipNode whose first member is a plain SLLNode, level 0 of the skip list
+// is the nextNode chain, so firstNode to nextNode iteration keeps working and
+// always sees values in key order. Higher levels are kept in forward, a node
+// gets every next level with probability 1/4. Nodes with equal keys are kept
+// in the order they were added, like sortList keeps them.
+
+struct SLLNode *_getSkipNext(struct SLLSkipNode *node, int level)
+{
+    return level == 0 ? node->node.nextNode : node->forward[level - 1];
+}
+
+void _setSkipNext(struct SLLSkipNode *node, int level, struct SLLNode *nextNode)
+{
+    if (level == 0)
+    {
+        node->node.nextNode = nextNode;
+    }
+    else
+    {
+        node->forward[level - 1] = nextNode;
+    }
+}
+
+struct SLLSkipNode *_newSkipNode(int level)
+{
+    struct SLLSkipNode *node = (struct SLLSkipNode *)malloc(sizeof(struct SLLSkipNode) + sizeof(struct SLLNode *) * (level - 1));
+
+    node->level = level;
+    for (int i = 0; i < level; i++)
+    {
+        _setSkipNext(node, i, NULL);
+    }
+
+    return node;
+}
+
+// Every list has its own xorshift64* generator, so levels do not depend on
+// and do not change the sequence of rand().
+int _getRandomSkipLevel(struct SLL *self)
+{
+    unsigned long long bits = 0;
+    int level = 1;
+
+    self->skipRandomState ^= self->skipRandomState >> 12;
+    self->skipRandomState ^= self->skipRandomState << 25;
+    self->skipRandomState ^= self->skipRandomState >> 27;
+    bits = self->skipRandomState * 0x2545F4914F6CDD1DULL;
+
+    // two bits per level, high bits of xorshift64* are the best ones
+    while (level < SLL_SKIP_LIST_MAX_LEVEL && ((bits >> (64 - 2 * level)) & 3) == 0)
+    {
+        level++;
+    }
+
+    return level;
+}
+
+// Fills update with the last node before key on every level. With
+// isAfterEqual the search also passes nodes with the same key.
+void _findSkipPredecessors(struct SLL *self, long long key, int isAfterEqual, struct SLLSkipNode **update)
+{
+    struct SLLSkipNode *node = self->skipHead;
+    struct SLLSkipNode *nextNode = NULL;
+
+    for (int level = self->skipHead->level - 1; level >= 0; level--)
+    {
+        while ((nextNode = (struct SLLSkipNode *)_getSkipNext(node, level)) != NULL &&
+               (nextNode->node.key < key || (isAfterEqual && nextNode->node.key == key)))
+        {
+            node = nextNode;
+        }
+        update[level] = node;
+    }
+}
+
+void addNodeSorted(struct SLL *self, char *value)
+{
+    struct SLLSkipNode *update[SLL_SKIP_LIST_MAX_LEVEL];
+    struct SLLSkipNode *newNode = _newSkipNode(_getRandomSkipLevel(self));
+    long long key = sumString(value);
+
+    newNode->node.value = value;
+    newNode->node.valueLength = strlen(value);
+    newNode->node.key = key;
+
+    _findSkipPredecessors(self, key, 1, update);
+
+    for (int level = 0; level < newNode->level; level++)
+    {
+        _setSkipNext(newNode, level, _getSkipNext(update[level], level));
+        _setSkipNext(update[level], level, &newNode->node);
+    }
+
+    if (newNode->node.nextNode == NULL)
+    {
+        self->lastNode = &newNode->node;
+    }
+    self->firstNode = self->skipHead->node.nextNode;
+    self->length++;
+}
+
+struct SLLNode *findNodeSorted(struct SLL *self, char *value)
+{
+    struct SLLSkipNode *update[SLL_SKIP_LIST_MAX_LEVEL];
+    long long key = sumString(value);
+    struct SLLNode *node = NULL;
+
+    _findSkipPredecessors(self, key, 0, update);
+
+    node = update[0]->node.nextNode;
+    while (node && node->key == key && strcmp(node->value, value) != 0)
+    {
+        node = node->nextNode;
+    }
+
+    return node && node->key == key ? node : NULL;
+}
+
+// Removes the first node with the given value. Predecessors found by key
+// may be before other nodes with the same key, on every level of the removed
+// node they are moved forward until they reach it.
+void deleteNodeSorted(struct SLL *self, char *value)
+{
+    struct SLLSkipNode *update[SLL_SKIP_LIST_MAX_LEVEL];
+    struct SLLSkipNode *node = NULL;
+    struct SLLNode *prevNode = NULL;
+    long long key = sumString(value);
+
+    _findSkipPredecessors(self, key, 0, update);
+
+    prevNode = &update[0]->node;
+    node = (struct SLLSkipNode *)prevNode->nextNode;
+    while (node && node->node.key == key && strcmp(node->node.value, value) != 0)
+    {
+        prevNode = &node->node;
+        node = (struct SLLSkipNode *)node->node.nextNode;
+    }
+
+    if (node == NULL || node->node.key != key)
+        return;
+
+    for (int level = 0; level < node->level; level++)
+    {
+        struct SLLSkipNode *levelNode = update[level];
+        while (_getSkipNext(levelNode, level) != &node->node)
+        {
+            levelNode = (struct SLLSkipNode *)_getSkipNext(levelNode, level);
+        }
+        _setSkipNext(levelNode, level, _getSkipNext(node, level));
+    }
+
+    if (self->lastNode == &node->node)
+    {
+        self->lastNode = prevNode == &self->skipHead->node ? NULL : prevNode;
+    }
+    self->firstNode = self->skipHead->node.nextNode;
+    self->length--;
+    free(node);
+}
+
+// Turns the nodes of a sorted list into a plain chain before another list
+// takes them: links above level 0 of every node and of the head are cleared,
+// so the sorted list does not reach the nodes through its head afterwards.
+void _detachSkipNodes(struct SLL *self)
+{
+    for (struct SLLNode *node = self->skipHead->node.nextNode; node; node = node->nextNode)
+    {
+        struct SLLSkipNode *skipNode = (struct SLLSkipNode *)node;
+        for (int level = 1; level < skipNode->level; level++)
+        {
+            _setSkipNext(skipNode, level, NULL);
+        }
+    }
+
+    for (int level = 0; level < self->skipHead->level; level++)
+    {
+        _setSkipNext(self->skipHead, level, NULL);
+    }
+}
+
+// Sorted list is always in key order.
+void sortListSorted(struct SLL *self)
+{
+    (void)self;
+}
+
+// Sorted list has to stay in key order for its skip levels, so it is not
+// reordered by strcmp.
+void sortListLexicographicSorted(struct SLL *self)
+{
+    (void)self;
+}
+
+// Skip levels already find a value in O(log n), there is no hash index to
+// enable, predecessors in it would not survive the next insert.
+void enableIndexSorted(struct SLL *self)
+{
+    (void)self;
+}
+
+void appendManySorted(struct SLL *self, char **values, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        addNodeSorted(self, values[i]);
+    }
+}
+
+// Values of the other list are inserted in order, its nodes are freed. A
+// list loaded from a file is left as it is, like splice does with it.
+void spliceSorted(struct SLL *self, struct SLL *otherList)
+{
+    if (self == otherList || otherList->mapping)
+        return;
+
+    while (otherList->firstNode)
+    {
+        char *value = otherList->firstNode->value;
+        otherList->deleteNode(otherList, value);
+        addNodeSorted(self, value);
+    }
+
+    for (struct SLLBlock *block = otherList->firstBlock; block; block = block->nextBlock)
+    {
+        appendManySorted(self, block->values, block->length);
+    }
+    while (otherList->firstBlock)
+    {
+        struct SLLBlock *block = otherList->firstBlock;
+        otherList->firstBlock = block->nextBlock;
+        free(block);
+    }
+
+    otherList->firstNode = NULL;
+    otherList->lastNode = NULL;
+    otherList->lastBlock = NULL;
+    otherList->length = 0;
+}
+
+struct SLL *getSortedSLL()
+{
+    struct SLL *newSll = getSLL();
+
+    newSll->skipHead = _newSkipNode(SLL_SKIP_LIST_MAX_LEVEL);
+    newSll->skipHead->node.value = NULL;
+    newSll->skipHead->node.key = 0;
+    newSll->skipHead->node.valueLength = 0;
+    newSll->skipRandomState = 0x9E3779B97F4A7C15ULL;
+
+    newSll->addNode = *addNodeSorted;
+    newSll->deleteNode = *deleteNodeSorted;
+    newSll->findNode = *findNodeSorted;
+    newSll->sortList = *sortListSorted;
+    newSll->appendMany = *appendManySorted;
+    newSll->splice = *spliceSorted;
+    newSll->sortListLexicographic = *sortListLexicographicSorted;
+    newSll->enableIndex = *enableIndexSorted;
+
+    return newSll;
+}
@@ -0,0 +1,152 @@
+#include "./sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "./utils.h"
+
+// List built from a newline-delimited text file without copying lines. The
+// file is mapped read-only and every node is a view of one line: value points
+// at its first character inside the mapping and valueLength is its length
+// without the line ending, nothing is written into the mapping, so its pages
+// stay shared with the page cache. Values are not followed by '\0', they are
+// compared with their length and printed with "%.*s". Nodes come from chunks
+// of SLL_NODE_CHUNK_LENGTH nodes owned by the list, they are released
+// together with the mapping by unloadSLL.
+
+struct SLLNode *_newMappingNode(struct SLLMapping *mapping)
+{
+    struct SLLNode *node = mapping->freeNodes;
+
+    if (node)
+    {
+        mapping->freeNodes = node->nextNode;
+        return node;
+    }
+
+    if (mapping->firstChunk == NULL || mapping->firstChunk->length == SLL_NODE_CHUNK_LENGTH)
+    {
+        struct SLLNodeChunk *chunk = (struct SLLNodeChunk *)malloc(sizeof(struct SLLNodeChunk));
+        chunk->nextChunk = mapping->firstChunk;
+        chunk->length = 0;
+        mapping->firstChunk = chunk;
+    }
+
+    return &mapping->firstChunk->nodes[mapping->firstChunk->length++];
+}
+
+// Returns NULL when the file can not be opened or mapped. A trailing "\r" of
+// a line is not part of the value, the empty string after the last line
+// ending is not a value.
+struct SLL *loadSLLFromFile(char *path)
+{
+    struct SLL *newSll = NULL;
+    struct SLLMapping *mapping = NULL;
+    struct SLLNode *firstNode = NULL, *lastNode = NULL, *newNode = NULL;
+    struct stat fileStat;
+    char *data = NULL, *line = NULL, *end = NULL, *lineEnd = NULL;
+    int fd = open(path, O_RDONLY), length = 0, valueLength = 0;
+
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // an empty file can not be mapped and has no lines
+    if (fileStat.st_size > 0)
+    {
+        data = (char *)mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            return NULL;
+        }
+    }
+    close(fd);
+
+    newSll = getSLL();
+    mapping = (struct SLLMapping *)malloc(sizeof(struct SLLMapping));
+    mapping->data = data;
+    mapping->mappedSize = fileStat.st_size;
+    mapping->firstChunk = NULL;
+    mapping->freeNodes = NULL;
+    newSll->mapping = mapping;
+
+    if (data)
+        madvise(data, mapping->mappedSize, MADV_SEQUENTIAL);
+
+    line = data;
+    end = data + fileStat.st_size;
+    while (line < end)
+    {
+        lineEnd = (char *)memchr(line, '\n', end - line);
+        if (lineEnd == NULL)
+            lineEnd = end;
+
+        valueLength = lineEnd - line;
+        if (valueLength > 0 && *(lineEnd - 1) == '\r')
+            valueLength--;
+
+        newNode = _newMappingNode(mapping);
+        newNode->value = line;
+        newNode->valueLength = valueLength;
+        newNode->key = sumStringView(line, valueLength);
+        newNode->nextNode = NULL;
+        if (lastNode)
+        {
+            lastNode->nextNode = newNode;
+        }
+        else
+        {
+            firstNode = newNode;
+        }
+        lastNode = newNode;
+        length++;
+
+        line = lineEnd + 1;
+    }
+
+    // values are read in any order from now on
+    if (data)
+        madvise(data, mapping->mappedSize, MADV_NORMAL);
+
+    if (firstNode)
+    {
+        _appendChain(newSll, firstNode, lastNode, length);
+    }
+
+    return newSll;
+}
+
+// Frees list loaded with loadSLLFromFile with all its nodes and the mapping,
+// values of the list can not be used after that.
+void unloadSLL(struct SLL *self)
+{
+    struct SLLNodeChunk *chunk = self->mapping->firstChunk, *nextChunk = NULL;
+
+    while (chunk)
+    {
+        nextChunk = chunk->nextChunk;
+        free(chunk);
+        chunk = nextChunk;
+    }
+
+    if (self->index)
+    {
+        _clearIndex(self->index);
+        free(self->index->buckets);
+        free(self->index->lastEntries);
+        free(self->index);
+    }
+
+    if (self->mapping->data)
+        munmap(self->mapping->data, self->mapping->mappedSize);
+    free(self->mapping);
+    free(self);
+}
@@ -0,0 +1,186 @@
+#include "./sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include "./utils.h"
+
+// Optional hash index of a node list. Every node has an entry keyed by hash
+// of its value which also points at the node before it, so a node can be
+// unlinked without walking the list. Entries with equal values stay in list
+// order inside a bucket, deleteNode still removes the first equal value.
+
+#define SLL_INDEX_INITIAL_BUCKET_COUNT 64
+
+void enableIndex(struct SLL *self)
+{
+    if (self->index)
+        return;
+
+    self->index = (struct SLLIndex *)malloc(sizeof(struct SLLIndex));
+    self->index->bucketCount = SLL_INDEX_INITIAL_BUCKET_COUNT;
+    self->index->buckets = (struct SLLIndexEntry **)calloc(self->index->bucketCount, sizeof(struct SLLIndexEntry *));
+    self->index->lastEntries = (struct SLLIndexEntry **)calloc(self->index->bucketCount, sizeof(struct SLLIndexEntry *));
+    self->index->length = 0;
+
+    _rebuildIndex(self);
+}
+
+void _rebuildIndex(struct SLL *self)
+{
+    struct SLLNode *node = self->firstNode, *prevNode = NULL;
+
+    _clearIndex(self->index);
+
+    while (node)
+    {
+        _addIndexEntry(self->index, node, prevNode);
+        prevNode = node;
+        node = node->nextNode;
+    }
+}
+
+void _clearIndex(struct SLLIndex *index)
+{
+    struct SLLIndexEntry *entry = NULL, *nextEntry = NULL;
+
+    for (int i = 0; i < index->bucketCount; i++)
+    {
+        entry = index->buckets[i];
+        while (entry)
+        {
+            nextEntry = entry->nextEntry;
+            free(entry);
+            entry = nextEntry;
+        }
+        index->buckets[i] = NULL;
+        index->lastEntries[i] = NULL;
+    }
+
+    index->length = 0;
+}
+
+// Appends entry after the last entry of its bucket, so many equal values do
+// not make building the index quadratic. Bucket count is doubled when there
+// are more entries than buckets, entries keep their order while moving.
+void _addIndexEntry(struct SLLIndex *index, struct SLLNode *node, struct SLLNode *prevNode)
+{
+    struct SLLIndexEntry *newEntry = (struct SLLIndexEntry *)malloc(sizeof(struct SLLIndexEntry));
+    int bucket = 0;
+
+    if (index->length >= index->bucketCount)
+    {
+        int bucketCount = index->bucketCount * 2;
+        struct SLLIndexEntry **buckets = (struct SLLIndexEntry **)calloc(bucketCount, sizeof(struct SLLIndexEntry *));
+        struct SLLIndexEntry **lastEntries = (struct SLLIndexEntry **)calloc(bucketCount, sizeof(struct SLLIndexEntry *));
+
+        for (int i = 0; i < index->bucketCount; i++)
+        {
+            struct SLLIndexEntry *entry = index->buckets[i], *nextEntry = NULL;
+            while (entry)
+            {
+                int bucket = entry->hash & (bucketCount - 1);
+                nextEntry = entry->nextEntry;
+                entry->nextEntry = NULL;
+
+                if (lastEntries[bucket])
+                {
+                    lastEntries[bucket]->nextEntry = entry;
+                }
+                else
+                {
+                    buckets[bucket] = entry;
+                }
+                lastEntries[bucket] = entry;
+
+                entry = nextEntry;
+            }
+        }
+
+        free(index->lastEntries);
+        free(index->buckets);
+        index->buckets = buckets;
+        index->lastEntries = lastEntries;
+        index->bucketCount = bucketCount;
+    }
+
+    newEntry->node = node;
+    newEntry->prevNode = prevNode;
+    newEntry->hash = hashStringView(node->value, node->valueLength);
+    newEntry->nextEntry = NULL;
+
+    bucket = newEntry->hash & (index->bucketCount - 1);
+    if (index->lastEntries[bucket])
+    {
+        index->lastEntries[bucket]->nextEntry = newEntry;
+    }
+    else
+    {
+        index->buckets[bucket] = newEntry;
+    }
+    index->lastEntries[bucket] = newEntry;
+    index->length++;
+}
+
+struct SLLIndexEntry *_findIndexEntry(struct SLLIndex *index, struct SLLNode *node)
+{
+    struct SLLIndexEntry *entry = index->buckets[hashStringView(node->value, node->valueLength) & (index->bucketCount - 1)];
+
+    while (entry && entry->node != node)
+    {
+        entry = entry->nextEntry;
+    }
+
+    return entry;
+}
+
+// Removes the first node with the given value in expected constant time.
+// The entry of the following node gets the removed node's predecessor.
+void _deleteNodeIndexed(struct SLL *self, char *value)
+{
+    unsigned long long hash = hashString(value);
+    int bucket = hash & (self->index->bucketCount - 1);
+    struct SLLIndexEntry **entryPtr = &self->index->buckets[bucket];
+    struct SLLIndexEntry *entry = NULL, *nextNodeEntry = NULL;
+    struct SLLNode *node = NULL, *prevNode = NULL;
+
+    while (*entryPtr && ((*entryPtr)->hash != hash || !_isNodeValue((*entryPtr)->node, value)))
+    {
+        entryPtr = &(*entryPtr)->nextEntry;
+    }
+
+    if (*entryPtr == NULL)
+        return;
+
+    entry = *entryPtr;
+    node = entry->node;
+    prevNode = entry->prevNode;
+    *entryPtr = entry->nextEntry;
+    if (self->index->lastEntries[bucket] == entry)
+    {
+        // nextEntry is the first member, so entryPtr is the entry before
+        self->index->lastEntries[bucket] = entryPtr == &self->index->buckets[bucket] ? NULL : (struct SLLIndexEntry *)entryPtr;
+    }
+    free(entry);
+    self->index->length--;
+
+    if (prevNode == NULL)
+    {
+        self->firstNode = node->nextNode;
+    }
+    else
+    {
+        prevNode->nextNode = node->nextNode;
+    }
+
+    if (node->nextNode)
+    {
+        nextNodeEntry = _findIndexEntry(self->index, node->nextNode);
+        nextNodeEntry->prevNode = prevNode;
+    }
+
+    if (self->lastNode == node)
+    {
+        self->lastNode = prevNode;
+    }
+    self->length--;
+    _freeNode(self, node);
+}
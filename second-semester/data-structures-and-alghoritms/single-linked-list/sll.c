@@ -2,15 +2,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include "./utils.h"
-#include <stdio.h>
 
 void deleteNode(struct SLL *self, char *value)
 {
     struct SLLNode *node = self->firstNode, *prevNode = NULL;
 
+    if (self->index)
+    {
+        _deleteNodeIndexed(self, value);
+        return;
+    }
+
     while (node != NULL)
     {
-        if (strcmp(node->value, value) == 0)
+        if (_isNodeValue(node, value))
         {
             if (prevNode == NULL)
             {
@@ -20,7 +25,12 @@ void deleteNode(struct SLL *self, char *value)
             {
                 prevNode->nextNode = node->nextNode;
             }
-            free(node);
+            if (self->lastNode == node)
+            {
+                self->lastNode = prevNode;
+            }
+            self->length--;
+            _freeNode(self, node);
             break;
         }
 
@@ -31,58 +41,289 @@ void deleteNode(struct SLL *self, char *value)
 
 void addNode(struct SLL *self, char *value)
 {
-    struct SLLNode *newNode = (struct SLLNode *)malloc(sizeof(struct SLLNode)), *node = self->firstNode;
+    struct SLLNode *newNode = _newNode(self);
 
     newNode->value = value;
+    newNode->valueLength = strlen(value);
     newNode->nextNode = NULL;
-    printf("%d\n", sumString(value));
+    newNode->key = sumString(value);
+
+    _appendChain(self, newNode, newNode, 1);
+}
+
+// Returns the first node with the given value or NULL. Keys are compared
+// before strings, with the index only one bucket is searched.
+struct SLLNode *findNode(struct SLL *self, char *value)
+{
+    struct SLLNode *node = self->firstNode;
+    long long key = 0;
 
-    if (self->firstNode == NULL)
+    if (self->index)
     {
-        self->firstNode = newNode;
+        unsigned long long hash = hashString(value);
+        struct SLLIndexEntry *entry = self->index->buckets[hash & (self->index->bucketCount - 1)];
+
+        while (entry && (entry->hash != hash || !_isNodeValue(entry->node, value)))
+        {
+            entry = entry->nextEntry;
+        }
+
+        return entry ? entry->node : NULL;
     }
-    else
+
+    key = sumString(value);
+    while (node && (node->key != key || !_isNodeValue(node, value)))
+    {
+        node = node->nextNode;
+    }
+
+    return node;
+}
+
+// Builds the nodes for all values as one chain and links it after the last
+// node, the list itself is touched once per call.
+void appendMany(struct SLL *self, char **values, int n)
+{
+    struct SLLNode *firstNode = NULL, *lastNode = NULL, *newNode = NULL;
+
+    for (int i = 0; i < n; i++)
+    {
+        newNode = _newNode(self);
+        newNode->value = values[i];
+        newNode->valueLength = strlen(values[i]);
+        newNode->nextNode = NULL;
+        newNode->key = sumString(values[i]);
+
+        if (lastNode)
+        {
+            lastNode->nextNode = newNode;
+        }
+        else
+        {
+            firstNode = newNode;
+        }
+        lastNode = newNode;
+    }
+
+    if (firstNode)
+    {
+        _appendChain(self, firstNode, lastNode, n);
+    }
+}
+
+// Moves all nodes of the other list to the end of this list, the other list
+// is left empty. Nodes of a list loaded from a file belong to its pool, so
+// values of a plain list are moved into new nodes of a loaded list. Values of
+// a loaded list point into its mapping and would dangle after unloadSLL of
+// that list, so it can not be spliced into another list, both lists are left
+// as they are. Splicing a list into itself does nothing. Nodes of a sorted
+// list are taken as a plain chain, its head is left without links. Values of
+// an unrolled list are appended as new nodes and its blocks are freed.
+void splice(struct SLL *self, struct SLL *otherList)
+{
+    if (self == otherList || (otherList->mapping && otherList->mapping != self->mapping))
+        return;
+
+    if (otherList->skipHead)
     {
-        while (node->nextNode != NULL)
+        _detachSkipNodes(otherList);
+    }
+
+    while (otherList->firstBlock)
+    {
+        struct SLLBlock *block = otherList->firstBlock;
+        appendMany(self, block->values, block->length);
+        otherList->firstBlock = block->nextBlock;
+        free(block);
+    }
+    otherList->lastBlock = NULL;
+
+    if (self->mapping != otherList->mapping)
+    {
+        struct SLLNode *node = otherList->firstNode, *nextNode = NULL;
+        while (node)
         {
-            node = node->nextNode;
+            nextNode = node->nextNode;
+            addNode(self, node->value);
+            _freeNode(otherList, node);
+            node = nextNode;
         }
-        node->nextNode = newNode;
     }
+    else if (otherList->firstNode)
+    {
+        _appendChain(self, otherList->firstNode, otherList->lastNode, otherList->length);
+    }
+
+    otherList->firstNode = NULL;
+    otherList->lastNode = NULL;
+    otherList->length = 0;
+    if (otherList->index)
+    {
+        _clearIndex(otherList->index);
+    }
+}
+
+// Value of a node equals a string ending with '\0', value of the node does not
+// have to end with it.
+int _isNodeValue(struct SLLNode *node, char *value)
+{
+    return strnlen(value, node->valueLength + 1) == (size_t)node->valueLength &&
+           memcmp(node->value, value, node->valueLength) == 0;
+}
+
+// Nodes of a list loaded from a file come from the pool of its mapping.
+struct SLLNode *_newNode(struct SLL *self)
+{
+    if (self->mapping)
+        return _newMappingNode(self->mapping);
+
+    return (struct SLLNode *)malloc(sizeof(struct SLLNode));
+}
+
+void _freeNode(struct SLL *self, struct SLLNode *node)
+{
+    if (self->mapping)
+    {
+        node->nextNode = self->mapping->freeNodes;
+        self->mapping->freeNodes = node;
+        return;
+    }
+
+    free(node);
+}
+
+void _appendChain(struct SLL *self, struct SLLNode *firstNode, struct SLLNode *lastNode, int length)
+{
+    if (self->index)
+    {
+        struct SLLNode *prevNode = self->lastNode;
+        for (struct SLLNode *node = firstNode; prevNode != lastNode; node = node->nextNode)
+        {
+            _addIndexEntry(self->index, node, prevNode);
+            prevNode = node;
+        }
+    }
+
+    if (self->lastNode == NULL)
+    {
+        self->firstNode = firstNode;
+    }
+    else
+    {
+        self->lastNode->nextNode = firstNode;
+    }
+
+    self->lastNode = lastNode;
+    self->length += length;
 }
 
 void sortList(struct SLL *self)
 {
-    self->firstNode = quickSort(self->firstNode);
+    struct SLLNode *node = NULL;
+
+    self->firstNode = mergeSort(self->firstNode);
+
+    node = self->firstNode;
+    while (node && node->nextNode)
+    {
+        node = node->nextNode;
+    }
+    self->lastNode = node;
+
+    // every predecessor changed, index is built again in the new order
+    if (self->index)
+    {
+        _rebuildIndex(self);
+    }
 }
 
-struct SLLNode *quickSort(struct SLLNode *firstNode)
+// Stable bottom-up merge sort by node key. Every node is merged into bins
+// where bin i holds a sorted run of 2^i nodes, so the list is read once and
+// no recursion is needed.
+struct SLLNode *mergeSort(struct SLLNode *firstNode)
+{
+    struct SLLNode *bins[64] = {NULL};
+    struct SLLNode *node = firstNode, *nextNode = NULL, *run = NULL;
+    int maxBin = 0, i = 0;
+
+    while (node)
+    {
+        nextNode = node->nextNode;
+        node->nextNode = NULL;
+        run = node;
+
+        // bins hold nodes which came earlier in the list, so they go first
+        for (i = 0; bins[i] != NULL; i++)
+        {
+            run = _mergeLists(bins[i], run);
+            bins[i] = NULL;
+        }
+        bins[i] = run;
+        if (i > maxBin)
+            maxBin = i;
+
+        node = nextNode;
+    }
+
+    run = NULL;
+    for (i = 0; i <= maxBin; i++)
+    {
+        if (bins[i])
+        {
+            run = run ? _mergeLists(bins[i], run) : bins[i];
+        }
+    }
+
+    return run;
+}
+
+// Merges two sorted lists, on equal keys nodes of the first list go first.
+struct SLLNode *_mergeLists(struct SLLNode *firstList, struct SLLNode *secondList)
+{
+    struct SLLNode head;
+    struct SLLNode *tail = &head;
+
+    while (firstList && secondList)
+    {
+        if (firstList->key <= secondList->key)
+        {
+            tail->nextNode = firstList;
+            firstList = firstList->nextNode;
+        }
+        else
+        {
+            tail->nextNode = secondList;
+            secondList = secondList->nextNode;
+        }
+        tail = tail->nextNode;
+    }
+    tail->nextNode = firstList ? firstList : secondList;
+
+    return head.nextNode;
+}
+
+struct SLLNode *quickSort(struct SLLNode *firstNode, int listLength)
 {
-    int listLength = 0;
     int middleIndex = 0;
+    int lessThanMiddleLength = 0;
+    int greaterThanMiddleLength = 0;
 
     struct SLLNode *node = NULL;
     struct SLLNode *nodeLessThanMiddle = NULL;
     struct SLLNode *nodeGreaterThanMiddle = NULL;
     struct SLLNode *nodeLessThanMiddlePtr = NULL;
     struct SLLNode *nodeGreaterThanMiddlePtr = NULL;
+    struct SLLNode *nodeEqualToMiddle = NULL;
+    struct SLLNode *nodeEqualToMiddlePtr = NULL;
     struct SLLNode *middleNode = NULL;
 
-    // get length
-    node = firstNode;
-    while (node)
-    {
-        node = node->nextNode;
-        listLength++;
-    }
-
     // check base case
     // swap in case if length is equal 2
     if (listLength == 2)
     {
         node = firstNode;
         struct SLLNode *tempNode = node->nextNode;
-        if (sumString(node->value) > sumString(tempNode->value))
+        if (node->key > tempNode->key)
         {
             tempNode->nextNode = node;
             node->nextNode = NULL;
@@ -117,7 +358,7 @@ struct SLLNode *quickSort(struct SLLNode *firstNode)
     while (node)
     {
         nextNode = node->nextNode;
-        if (sumString(node->value) < sumString(middleNode->value))
+        if (node->key < middleNode->key)
         {
             if (nodeLessThanMiddlePtr)
             {
@@ -129,8 +370,9 @@ struct SLLNode *quickSort(struct SLLNode *firstNode)
             }
             nodeLessThanMiddlePtr = node;
             node->nextNode = NULL;
+            lessThanMiddleLength++;
         }
-        else if (sumString(node->value) > sumString(middleNode->value))
+        else if (node->key > middleNode->key)
         {
             if (nodeGreaterThanMiddlePtr)
             {
@@ -142,14 +384,29 @@ struct SLLNode *quickSort(struct SLLNode *firstNode)
             }
             nodeGreaterThanMiddlePtr = node;
             node->nextNode = NULL;
+            greaterThanMiddleLength++;
+        }
+        else if (node != middleNode)
+        {
+            // nodes with the same key as the middle node go right after it
+            if (nodeEqualToMiddlePtr)
+            {
+                nodeEqualToMiddlePtr->nextNode = node;
+            }
+            else
+            {
+                nodeEqualToMiddle = node;
+            }
+            nodeEqualToMiddlePtr = node;
+            node->nextNode = NULL;
         }
 
         node = nextNode;
     }
 
     // recursive call of quick sort
-    nodeLessThanMiddle = quickSort(nodeLessThanMiddle);
-    nodeGreaterThanMiddle = quickSort(nodeGreaterThanMiddle);
+    nodeLessThanMiddle = quickSort(nodeLessThanMiddle, lessThanMiddleLength);
+    nodeGreaterThanMiddle = quickSort(nodeGreaterThanMiddle, greaterThanMiddleLength);
 
     if (nodeLessThanMiddle)
     {
@@ -161,24 +418,40 @@ struct SLLNode *quickSort(struct SLLNode *firstNode)
         }
 
         nodeLessThanMiddlePtr->nextNode = middleNode;
+    }
 
-        middleNode->nextNode = nodeGreaterThanMiddle;
-
-        return nodeLessThanMiddle;
+    if (nodeEqualToMiddle)
+    {
+        middleNode->nextNode = nodeEqualToMiddle;
+        nodeEqualToMiddlePtr->nextNode = nodeGreaterThanMiddle;
     }
     else
     {
         middleNode->nextNode = nodeGreaterThanMiddle;
-        return middleNode;
     }
+
+    return nodeLessThanMiddle ? nodeLessThanMiddle : middleNode;
 }
 
 struct SLL *getSLL()
 {
     struct SLL *newSll = (struct SLL *)malloc(sizeof(struct SLL));
+    newSll->firstNode = NULL;
+    newSll->lastNode = NULL;
+    newSll->firstBlock = NULL;
+    newSll->lastBlock = NULL;
+    newSll->index = NULL;
+    newSll->skipHead = NULL;
+    newSll->mapping = NULL;
+    newSll->length = 0;
     newSll->addNode = *addNode;
+    newSll->findNode = *findNode;
     newSll->deleteNode = *deleteNode;
     newSll->sortList = *sortList;
+    newSll->sortListLexicographic = *sortListLexicographic;
+    newSll->appendMany = *appendMany;
+    newSll->splice = *splice;
+    newSll->enableIndex = *enableIndex;
 
     return newSll;
 }
\ No newline at end of file
@@ -1,19 +1,154 @@
+// Value of a node is a view of valueLength characters. Values given to
+// addNode end with '\0' after them, values of a list loaded from a file are
+// lines inside the read-only mapping and do not.
 struct SLLNode
 {
     struct SLLNode *nextNode;
     char *value;
+    long long key;
+    int valueLength;
+};
+
+#define SLL_BLOCK_CAPACITY 64
+
+// Block of unrolled singly linked list, values and their keys are stored in
+// arrays so scans over a block read memory sequentially.
+struct SLLBlock
+{
+    struct SLLBlock *nextBlock;
+    int length;
+    long long keys[SLL_BLOCK_CAPACITY];
+    char *values[SLL_BLOCK_CAPACITY];
+};
+
+// Entry of the optional hash index of a node list. prevNode is the node
+// before the indexed node, NULL for the first node.
+struct SLLIndexEntry
+{
+    struct SLLIndexEntry *nextEntry;
+    struct SLLNode *node;
+    struct SLLNode *prevNode;
+    unsigned long long hash;
+};
+
+struct SLLIndex
+{
+    struct SLLIndexEntry **buckets;
+    // last entry of every bucket, so an entry is appended without a walk
+    struct SLLIndexEntry **lastEntries;
+    int bucketCount;
+    int length;
+};
+
+#define SLL_NODE_CHUNK_LENGTH 4096
+
+// Nodes of a list loaded from a file are allocated in chunks, deleted nodes
+// go to freeNodes and are given out again by the next addNode.
+struct SLLNodeChunk
+{
+    struct SLLNodeChunk *nextChunk;
+    int length;
+    struct SLLNode nodes[SLL_NODE_CHUNK_LENGTH];
+};
+
+// File mapped read-only by loadSLLFromFile, values of the list point into data.
+struct SLLMapping
+{
+    char *data;
+    unsigned long mappedSize;
+    struct SLLNodeChunk *firstChunk;
+    struct SLLNode *freeNodes;
+};
+
+#define SLL_SKIP_LIST_MAX_LEVEL 32
+
+// Node of the sorted list. The plain node comes first, so a skip node is also
+// a SLLNode and node.nextNode is its link on level 0. forward[i] is the link
+// on level i + 1, there are level - 1 of them.
+struct SLLSkipNode
+{
+    struct SLLNode node;
+    int level;
+    struct SLLNode *forward[];
 };
 
 struct SLL
 {
     struct SLLNode *firstNode;
+    struct SLLNode *lastNode;
+    struct SLLBlock *firstBlock;
+    struct SLLBlock *lastBlock;
+    struct SLLIndex *index;
+    struct SLLSkipNode *skipHead;
+    // xorshift state for levels of skip nodes, so rand() is left to the caller
+    unsigned long long skipRandomState;
+    struct SLLMapping *mapping;
+    // node returned by findNode of an unrolled list, which has no nodes
+    struct SLLNode foundNode;
+    int length;
     void (*deleteNode)(struct SLL *self, char *value);
     void (*addNode)(struct SLL *self, char *value);
+    struct SLLNode *(*findNode)(struct SLL *self, char *value);
     void (*sortList)(struct SLL *self);
+    void (*sortListLexicographic)(struct SLL *self);
+    void (*appendMany)(struct SLL *self, char **values, int n);
+    void (*splice)(struct SLL *self, struct SLL *otherList);
+    void (*enableIndex)(struct SLL *self);
 };
 
 void deleteNode(struct SLL *self, char *value);
 void addNode(struct SLL *self, char *value);
+struct SLLNode *findNode(struct SLL *self, char *value);
 void sortList(struct SLL *self);
-struct SLLNode *quickSort(struct SLLNode *firstNode);
-struct SLL *getSLL();
\ No newline at end of file
+void sortListLexicographic(struct SLL *self);
+void sortListLexicographicUnrolled(struct SLL *self);
+void appendMany(struct SLL *self, char **values, int n);
+void splice(struct SLL *self, struct SLL *otherList);
+struct SLLNode *_newNode(struct SLL *self);
+void _freeNode(struct SLL *self, struct SLLNode *node);
+void _appendChain(struct SLL *self, struct SLLNode *firstNode, struct SLLNode *lastNode, int length);
+struct SLLNode *quickSort(struct SLLNode *firstNode, int listLength);
+struct SLLNode *mergeSort(struct SLLNode *firstNode);
+struct SLLNode *_mergeLists(struct SLLNode *firstList, struct SLLNode *secondList);
+int _isNodeValue(struct SLLNode *node, char *value);
+struct SLL *getSLL();
+
+void enableIndex(struct SLL *self);
+void _rebuildIndex(struct SLL *self);
+void _clearIndex(struct SLLIndex *index);
+void _addIndexEntry(struct SLLIndex *index, struct SLLNode *node, struct SLLNode *prevNode);
+struct SLLIndexEntry *_findIndexEntry(struct SLLIndex *index, struct SLLNode *node);
+void _deleteNodeIndexed(struct SLL *self, char *value);
+
+void deleteNodeUnrolled(struct SLL *self, char *value);
+void addNodeUnrolled(struct SLL *self, char *value);
+void sortListUnrolled(struct SLL *self);
+void appendManyUnrolled(struct SLL *self, char **values, int n);
+void spliceUnrolled(struct SLL *self, struct SLL *otherList);
+struct SLLNode *findNodeUnrolled(struct SLL *self, char *value);
+void enableIndexUnrolled(struct SLL *self);
+struct SLLBlock *_newBlock();
+void _rebalanceBlock(struct SLL *self, struct SLLBlock *block, struct SLLBlock *prevBlock);
+void _sortBlock(struct SLLBlock *block);
+struct SLLBlock *_mergeBlockLists(struct SLLBlock *firstList, struct SLLBlock *secondList);
+struct SLL *getUnrolledSLL();
+
+struct SLL *loadSLLFromFile(char *path);
+void unloadSLL(struct SLL *self);
+struct SLLNode *_newMappingNode(struct SLLMapping *mapping);
+
+void deleteNodeSorted(struct SLL *self, char *value);
+void addNodeSorted(struct SLL *self, char *value);
+struct SLLNode *findNodeSorted(struct SLL *self, char *value);
+void sortListSorted(struct SLL *self);
+void sortListLexicographicSorted(struct SLL *self);
+void enableIndexSorted(struct SLL *self);
+void appendManySorted(struct SLL *self, char **values, int n);
+void spliceSorted(struct SLL *self, struct SLL *otherList);
+struct SLLNode *_getSkipNext(struct SLLSkipNode *node, int level);
+void _setSkipNext(struct SLLSkipNode *node, int level, struct SLLNode *nextNode);
+struct SLLSkipNode *_newSkipNode(int level);
+int _getRandomSkipLevel(struct SLL *self);
+void _findSkipPredecessors(struct SLL *self, long long key, int isAfterEqual, struct SLLSkipNode **update);
+void _detachSkipNodes(struct SLL *self);
+struct SLL *getSortedSLL();
\ No newline at end of file
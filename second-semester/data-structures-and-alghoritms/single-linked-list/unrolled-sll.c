@@ -0,0 +1,337 @@
+#include "./sll.h"
+#include <stdlib.h>
+#include <string.h>
+#include "./utils.h"
+
+// Unrolled singly linked list, values are kept in blocks of up to
+// SLL_BLOCK_CAPACITY entries instead of one node per value. firstNode and
+// lastNode stay NULL, the list is walked through firstBlock and nextBlock.
+
+struct SLLBlock *_newBlock()
+{
+    struct SLLBlock *block = (struct SLLBlock *)malloc(sizeof(struct SLLBlock));
+    block->nextBlock = NULL;
+    block->length = 0;
+
+    return block;
+}
+
+void addNodeUnrolled(struct SLL *self, char *value)
+{
+    struct SLLBlock *block = self->lastBlock;
+
+    if (block == NULL || block->length == SLL_BLOCK_CAPACITY)
+    {
+        block = _newBlock();
+        if (self->lastBlock)
+        {
+            self->lastBlock->nextBlock = block;
+        }
+        else
+        {
+            self->firstBlock = block;
+        }
+        self->lastBlock = block;
+    }
+
+    block->keys[block->length] = sumString(value);
+    block->values[block->length] = value;
+    block->length++;
+    self->length++;
+}
+
+void appendManyUnrolled(struct SLL *self, char **values, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        addNodeUnrolled(self, values[i]);
+    }
+}
+
+// Moves all values of the other list to the end of this list. Blocks of an
+// unrolled list are linked as they are, values of a node list are added one
+// by one and its nodes are freed. A list loaded from a file is left as it is,
+// its values are not strings ending with '\0'. Splicing a list into itself
+// does nothing.
+void spliceUnrolled(struct SLL *self, struct SLL *otherList)
+{
+    if (self == otherList || otherList->mapping)
+        return;
+
+    if (otherList->skipHead)
+    {
+        _detachSkipNodes(otherList);
+    }
+    while (otherList->firstNode)
+    {
+        struct SLLNode *node = otherList->firstNode;
+        otherList->firstNode = node->nextNode;
+        addNodeUnrolled(self, node->value);
+        free(node);
+    }
+    otherList->lastNode = NULL;
+    if (otherList->index)
+    {
+        _clearIndex(otherList->index);
+    }
+
+    if (otherList->firstBlock)
+    {
+        if (self->lastBlock)
+        {
+            self->lastBlock->nextBlock = otherList->firstBlock;
+        }
+        else
+        {
+            self->firstBlock = otherList->firstBlock;
+        }
+        self->lastBlock = otherList->lastBlock;
+        self->length += otherList->length;
+    }
+
+    otherList->firstBlock = NULL;
+    otherList->lastBlock = NULL;
+    otherList->length = 0;
+}
+
+// Removes the first value equal to the given one. Keys of a block are
+// compared first, strings are only compared when keys match.
+void deleteNodeUnrolled(struct SLL *self, char *value)
+{
+    struct SLLBlock *block = self->firstBlock, *prevBlock = NULL;
+    long long key = sumString(value);
+
+    while (block != NULL)
+    {
+        for (int i = 0; i < block->length; i++)
+        {
+            if (block->keys[i] == key && strcmp(block->values[i], value) == 0)
+            {
+                memmove(block->keys + i, block->keys + i + 1, sizeof(long long) * (block->length - i - 1));
+                memmove(block->values + i, block->values + i + 1, sizeof(char *) * (block->length - i - 1));
+                block->length--;
+                self->length--;
+
+                _rebalanceBlock(self, block, prevBlock);
+                return;
+            }
+        }
+
+        prevBlock = block;
+        block = block->nextBlock;
+    }
+}
+
+// Keeps blocks at least half full after a delete, the block either takes
+// values from the front of the next block or is merged with it. Empty blocks
+// are unlinked.
+void _rebalanceBlock(struct SLL *self, struct SLLBlock *block, struct SLLBlock *prevBlock)
+{
+    struct SLLBlock *nextBlock = block->nextBlock;
+    int moveLength = 0;
+
+    if (block->length >= SLL_BLOCK_CAPACITY / 2)
+        return;
+
+    if (nextBlock != NULL)
+    {
+        if (block->length + nextBlock->length <= SLL_BLOCK_CAPACITY)
+        {
+            moveLength = nextBlock->length;
+        }
+        else
+        {
+            moveLength = SLL_BLOCK_CAPACITY / 2 - block->length;
+        }
+
+        memcpy(block->keys + block->length, nextBlock->keys, sizeof(long long) * moveLength);
+        memcpy(block->values + block->length, nextBlock->values, sizeof(char *) * moveLength);
+        memmove(nextBlock->keys, nextBlock->keys + moveLength, sizeof(long long) * (nextBlock->length - moveLength));
+        memmove(nextBlock->values, nextBlock->values + moveLength, sizeof(char *) * (nextBlock->length - moveLength));
+        block->length += moveLength;
+        nextBlock->length -= moveLength;
+
+        if (nextBlock->length == 0)
+        {
+            block->nextBlock = nextBlock->nextBlock;
+            if (self->lastBlock == nextBlock)
+            {
+                self->lastBlock = block;
+            }
+            free(nextBlock);
+        }
+    }
+    else if (block->length == 0)
+    {
+        if (prevBlock)
+        {
+            prevBlock->nextBlock = NULL;
+        }
+        else
+        {
+            self->firstBlock = NULL;
+        }
+        self->lastBlock = prevBlock;
+        free(block);
+    }
+}
+
+// Sorts every block in place with insertion sort, then merges sorted block
+// lists bottom-up the same way mergeSort merges nodes. Merged blocks are
+// written full, so sorting also compacts the list.
+void sortListUnrolled(struct SLL *self)
+{
+    struct SLLBlock *bins[64] = {NULL};
+    struct SLLBlock *block = self->firstBlock, *nextBlock = NULL, *run = NULL;
+    int maxBin = 0, i = 0;
+
+    while (block)
+    {
+        nextBlock = block->nextBlock;
+        block->nextBlock = NULL;
+        _sortBlock(block);
+        run = block;
+
+        for (i = 0; bins[i] != NULL; i++)
+        {
+            run = _mergeBlockLists(bins[i], run);
+            bins[i] = NULL;
+        }
+        bins[i] = run;
+        if (i > maxBin)
+            maxBin = i;
+
+        block = nextBlock;
+    }
+
+    run = NULL;
+    for (i = 0; i <= maxBin; i++)
+    {
+        if (bins[i])
+        {
+            run = run ? _mergeBlockLists(bins[i], run) : bins[i];
+        }
+    }
+
+    self->firstBlock = run;
+    self->lastBlock = run;
+    while (self->lastBlock && self->lastBlock->nextBlock)
+    {
+        self->lastBlock = self->lastBlock->nextBlock;
+    }
+}
+
+void _sortBlock(struct SLLBlock *block)
+{
+    for (int i = 1; i < block->length; i++)
+    {
+        long long key = block->keys[i];
+        char *value = block->values[i];
+        int j = i - 1;
+
+        while (j >= 0 && block->keys[j] > key)
+        {
+            block->keys[j + 1] = block->keys[j];
+            block->values[j + 1] = block->values[j];
+            j--;
+        }
+        block->keys[j + 1] = key;
+        block->values[j + 1] = value;
+    }
+}
+
+// Merges two sorted block lists into new full blocks, input blocks are freed
+// as soon as they are consumed. On equal keys values of the first list go
+// first.
+struct SLLBlock *_mergeBlockLists(struct SLLBlock *firstList, struct SLLBlock *secondList)
+{
+    struct SLLBlock *mergedList = _newBlock(), *mergedBlock = mergedList, *consumedBlock = NULL;
+    int firstIndex = 0, secondIndex = 0;
+
+    while (firstList || secondList)
+    {
+        if (mergedBlock->length == SLL_BLOCK_CAPACITY)
+        {
+            mergedBlock->nextBlock = _newBlock();
+            mergedBlock = mergedBlock->nextBlock;
+        }
+
+        if (secondList == NULL || (firstList && firstList->keys[firstIndex] <= secondList->keys[secondIndex]))
+        {
+            mergedBlock->keys[mergedBlock->length] = firstList->keys[firstIndex];
+            mergedBlock->values[mergedBlock->length] = firstList->values[firstIndex];
+            firstIndex++;
+
+            if (firstIndex == firstList->length)
+            {
+                consumedBlock = firstList;
+                firstList = firstList->nextBlock;
+                firstIndex = 0;
+                free(consumedBlock);
+            }
+        }
+        else
+        {
+            mergedBlock->keys[mergedBlock->length] = secondList->keys[secondIndex];
+            mergedBlock->values[mergedBlock->length] = secondList->values[secondIndex];
+            secondIndex++;
+
+            if (secondIndex == secondList->length)
+            {
+                consumedBlock = secondList;
+                secondList = secondList->nextBlock;
+                secondIndex = 0;
+                free(consumedBlock);
+            }
+        }
+        mergedBlock->length++;
+    }
+
+    return mergedList;
+}
+
+// Scans keys of every block and returns self->foundNode with the first
+// equal value, NULL when there is none. The node is overwritten by the next
+// call and its nextNode is NULL.
+struct SLLNode *findNodeUnrolled(struct SLL *self, char *value)
+{
+    long long key = sumString(value);
+
+    for (struct SLLBlock *block = self->firstBlock; block; block = block->nextBlock)
+    {
+        for (int i = 0; i < block->length; i++)
+        {
+            if (block->keys[i] == key && strcmp(block->values[i], value) == 0)
+            {
+                self->foundNode.nextNode = NULL;
+                self->foundNode.value = block->values[i];
+                self->foundNode.valueLength = strlen(block->values[i]);
+                self->foundNode.key = key;
+                return &self->foundNode;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// Blocks are searched by their key arrays, there is no hash index to enable.
+void enableIndexUnrolled(struct SLL *self)
+{
+    (void)self;
+}
+
+struct SLL *getUnrolledSLL()
+{
+    struct SLL *newSll = getSLL();
+    newSll->addNode = *addNodeUnrolled;
+    newSll->deleteNode = *deleteNodeUnrolled;
+    newSll->sortList = *sortListUnrolled;
+    newSll->sortListLexicographic = *sortListLexicographicUnrolled;
+    newSll->appendMany = *appendManyUnrolled;
+    newSll->splice = *spliceUnrolled;
+    newSll->findNode = *findNodeUnrolled;
+    newSll->enableIndex = *enableIndexUnrolled;
+
+    return newSll;
+}
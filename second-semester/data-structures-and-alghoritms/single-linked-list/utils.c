@@ -1,14 +1,220 @@
 #include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "./utils.h"
 
-int sumString(char *str)
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SUM_STRING_SIMD
+#endif
+
+// sumString is sum of ((strLength - i) * 254 + str[i]) over all characters,
+// characters are signed as char is on x86. Weights do not depend on the
+// characters, so the sum is 254 * strLength * (strLength + 1) / 2 plus the
+// sum of characters, and both parts are collected in one pass.
+long long _combineSum(long long strLength, long long charSum)
+{
+    return 254 * (strLength * (strLength + 1) / 2) + charSum;
+}
+
+long long sumStringScalar(char *str)
+{
+    long long strLength = 0, charSum = 0;
+
+    while (*(str + strLength) != '\0')
+    {
+        charSum += (signed char)*(str + strLength);
+        strLength++;
+    }
+
+    return _combineSum(strLength, charSum);
+}
+
+#ifdef SUM_STRING_SIMD
+
+// Vector kernels read whole aligned blocks, an aligned block never crosses
+// a page, so reading past the terminator is safe. Characters are xor-ed with
+// 0x80, which maps signed char c to unsigned c + 128, summed with psadbw and
+// the 128 per character is subtracted at the end. Address sanitizer is
+// switched off for these kernels because of the over-read.
+
+__attribute__((no_sanitize_address)) long long sumStringSSE2(char *str)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    const __m128i indexes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i sums = _mm_setzero_si128();
+    long long strLength = 0, charSum = 0, simdLength = 0;
+
+    // characters before the first aligned block
+    while (((uintptr_t)(str + strLength) & 15) != 0)
+    {
+        if (*(str + strLength) == '\0')
+            return _combineSum(strLength, charSum);
+        charSum += (signed char)*(str + strLength);
+        strLength++;
+    }
+
+    simdLength = strLength;
+    while (true)
+    {
+        __m128i block = _mm_load_si128((const __m128i *)(str + strLength));
+        int zeroMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+        __m128i biased = _mm_xor_si128(block, bias);
+
+        if (zeroMask != 0)
+        {
+            int blockLength = __builtin_ctz(zeroMask);
+            __m128i keep = _mm_cmpgt_epi8(_mm_set1_epi8((char)blockLength), indexes);
+            sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(biased, keep), zero));
+            strLength += blockLength;
+            break;
+        }
+
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(biased, zero));
+        strLength += 16;
+    }
+
+    charSum += _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+    charSum -= 128 * (strLength - simdLength);
+
+    return _combineSum(strLength, charSum);
+}
+
+__attribute__((target("avx2"), no_sanitize_address)) long long sumStringAVX2(char *str)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi8((char)0x80);
+    const __m256i indexes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                             16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    __m256i sums = _mm256_setzero_si256();
+    long long strLength = 0, charSum = 0, simdLength = 0;
+
+    while (((uintptr_t)(str + strLength) & 31) != 0)
+    {
+        if (*(str + strLength) == '\0')
+            return _combineSum(strLength, charSum);
+        charSum += (signed char)*(str + strLength);
+        strLength++;
+    }
+
+    simdLength = strLength;
+    while (true)
+    {
+        __m256i block = _mm256_load_si256((const __m256i *)(str + strLength));
+        unsigned int zeroMask = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero));
+        __m256i biased = _mm256_xor_si256(block, bias);
+
+        if (zeroMask != 0)
+        {
+            int blockLength = __builtin_ctz(zeroMask);
+            __m256i keep = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)blockLength), indexes);
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_and_si256(biased, keep), zero));
+            strLength += blockLength;
+            break;
+        }
+
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(biased, zero));
+        strLength += 32;
+    }
+
+    charSum += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+               _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    charSum -= 128 * (strLength - simdLength);
+
+    return _combineSum(strLength, charSum);
+}
+
+#endif
+
+// Same as sumString for the first length characters of str, which do not
+// have to be followed by '\0', like a line inside a mapped file. Blocks of 16
+// characters are summed with SSE2 unaligned loads, nothing past str + length
+// is read.
+long long sumStringView(char *str, long long length)
 {
-    int i = 0, strLength = strlen(str);
-    long long sum = 0;
-    while (*(str + i) != '\0')
+    long long charSum = 0, i = 0;
+
+#ifdef SUM_STRING_SIMD
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi8((char)0x80);
+    __m128i sums = _mm_setzero_si128();
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(str + i));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_xor_si128(block, bias), zero));
+    }
+    charSum = _mm_cvtsi128_si64(sums) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)) - 128 * i;
+#endif
+
+    for (; i < length; i++)
+    {
+        charSum += (signed char)*(str + i);
+    }
+
+    return _combineSum(length, charSum);
+}
+
+// Kernel used by sumString, it is selected before main runs and only read
+// afterwards, so threads calling sumString do not race on it.
+long long (*_sumStringKernel)(char *str) = sumStringScalar;
+
+// Picks the widest kernel the CPU supports, every kernel gives the same
+// result.
+__attribute__((constructor)) void _selectSumStringKernel()
+{
+#ifdef SUM_STRING_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        _sumStringKernel = sumStringAVX2;
+    }
+    else
+    {
+        _sumStringKernel = sumStringSSE2;
+    }
+#endif
+}
+
+long long sumString(char *str)
+{
+    return _sumStringKernel(str);
+}
+
+void sumStrings(char **strs, long long *sums, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        sums[i] = _sumStringKernel(strs[i]);
+    }
+}
+
+// 64-bit FNV-1a hash
+unsigned long long hashString(char *str)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    while (*str != '\0')
+    {
+        hash ^= (unsigned char)*str;
+        hash *= 1099511628211ULL;
+        str++;
+    }
+
+    return hash;
+}
+
+// Same as hashString for the first length characters of str.
+unsigned long long hashStringView(char *str, long long length)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (long long i = 0; i < length; i++)
     {
-        sum += ((strLength - i) * 254) + *(str + i);
-        i++;
+        hash ^= (unsigned char)*(str + i);
+        hash *= 1099511628211ULL;
     }
 
-    return sum;
-}
\ No newline at end of file
+    return hash;
+}
@@ -1 +1,10 @@
-int sumString(char *str);
\ No newline at end of file
+long long sumString(char *str);
+void sumStrings(char **strs, long long *sums, int n);
+long long sumStringScalar(char *str);
+long long sumStringView(char *str, long long length);
+#if defined(__x86_64__)
+long long sumStringSSE2(char *str);
+long long sumStringAVX2(char *str);
+#endif
+unsigned long long hashString(char *str);
+unsigned long long hashStringView(char *str, long long length);
\ No newline at end of file